@@ -0,0 +1,90 @@
+/*
+ ==============================================================================
+
+ Main.cpp
+
+ Console driver of GrisLookAndFeelBenchmark: runs the whole matrix headless and
+ writes the results as JSON or CSV, to compare releases.
+
+ ==============================================================================
+ */
+
+#include "../GrisLookAndFeelBenchmark.h"
+
+#include <iostream>
+
+GRIS_DEFINE_ALLOCATION_COUNTING_OPERATORS
+
+static int printUsage (const String& error){
+    if (error.isNotEmpty())
+        std::cerr << error << std::endl;
+
+    std::cerr << "usage: GrisLookAndFeelBenchmark [--json | --csv] [--iterations N] [--output FILE]" << std::endl
+              << "  --json          write the results as JSON (the default)" << std::endl
+              << "  --csv           write the results as CSV" << std::endl
+              << "  --iterations N  calls timed per cell of the matrix, 200 by default" << std::endl
+              << "  --output FILE   write to FILE instead of the standard output" << std::endl;
+
+    return error.isNotEmpty() ? 1 : 0;
+}
+
+int main (int argc, char* argv[]){
+    const StringArray args (argv + 1, argc - 1);
+    bool asCsv = false;
+    int iterations = 200;
+    String output;
+
+    for (int i = 0; i < args.size(); ++i){
+        const String& arg = args[i];
+
+        if (arg == "--json"){
+            asCsv = false;
+        }else if (arg == "--csv"){
+            asCsv = true;
+        }else if (arg == "--iterations" && i + 1 < args.size()){
+            iterations = args[++i].getIntValue();
+
+            if (iterations <= 0)
+                return printUsage ("invalid number of iterations: " + args[i]);
+        }else if (arg == "--output" && i + 1 < args.size()){
+            output = args[++i];
+        }else if (arg == "--help" || arg == "-h"){
+            return printUsage (String());
+        }else{
+            return printUsage ("unknown argument: " + arg);
+        }
+    }
+
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    String text;
+
+    // glyph atlases are built afresh in a directory of their own, so that every run times the same work
+    const File atlasDirectory (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("GrisGlyphAtlas", String()));
+
+    {
+        SharedResourcePointer<GrisGlyphAtlasCache> glyphAtlases;
+        glyphAtlases->setCacheDirectory (atlasDirectory);
+
+        GrisLookAndFeel lnf;
+        GrisLookAndFeelBenchmark bench (lnf);
+        bench.setIterations (iterations);
+        bench.run();
+        text = asCsv ? bench.toCsv() : bench.toJson();
+    }
+
+    atlasDirectory.deleteRecursively();
+
+    if (output.isEmpty()){
+        std::cout << text << std::endl;
+        return 0;
+    }
+
+    const File file (File::getCurrentWorkingDirectory().getChildFile (output));
+
+    if (! file.replaceWithText (text)){
+        std::cerr << "could not write " << file.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
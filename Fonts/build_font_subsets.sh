@@ -0,0 +1,50 @@
+#!/usr/bin/env bash
+#
+# Subsets the GRIS fonts to the characters our UIs print and gzips them, so the
+# plugins can embed Fonts/subset/*.gz through BinaryData instead of the full fonts.
+# GrisSharedTypeface looks for "<resource>_gz" first and inflates it on first use.
+#
+# Needs fontTools (pip install fonttools). Run from anywhere:
+#     Fonts/build_font_subsets.sh [font files...]
+# Without arguments every font under Fonts/ is processed.
+
+set -euo pipefail
+
+FONTS_DIR="$(cd "$(dirname "$0")" && pwd)"
+OUT_DIR="$FONTS_DIR/subset"
+
+# Basic Latin, Latin-1 (French accents, degree sign, ...), dashes, quotes, bullet, ellipsis.
+UNICODES="U+0020-007E,U+00A0-00FF,U+0152-0153,U+2013-2014,U+2018-201E,U+2022,U+2026,U+2212"
+
+command -v pyftsubset >/dev/null || { echo "pyftsubset not found: pip install fonttools" >&2; exit 1; }
+
+mkdir -p "$OUT_DIR"
+
+if [ "$#" -gt 0 ]; then
+    FONTS=("$@")
+else
+    mapfile -t FONTS < <(find "$FONTS_DIR" -path "$OUT_DIR" -prune -o \( -name '*.otf' -o -name '*.ttf' \) -print | sort)
+fi
+
+total_before=0
+total_after=0
+
+printf '%-40s %10s %10s\n' "font" "original" "subset.gz"
+
+for font in "${FONTS[@]}"; do
+    name="$(basename "$font")"
+    subset="$OUT_DIR/$name"
+
+    pyftsubset "$font" --unicodes="$UNICODES" --layout-features='kern,liga' \
+               --notdef-outline --name-IDs='*' --output-file="$subset"
+    gzip -9nf "$subset"
+
+    before=$(wc -c < "$font")
+    after=$(wc -c < "$subset.gz")
+    total_before=$((total_before + before))
+    total_after=$((total_after + after))
+
+    printf '%-40s %10d %10d\n' "$name" "$before" "$after"
+done
+
+printf '%-40s %10d %10d\n' "total" "$total_before" "$total_after"
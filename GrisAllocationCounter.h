@@ -0,0 +1,128 @@
+/*
+ ==============================================================================
+
+ GrisAllocationCounter.h
+
+ Counts heap allocations per thread, so that paint code can be checked for
+ allocations in benchmarks and debug builds.
+
+ ==============================================================================
+ */
+
+#ifndef GRISALLOCATIONCOUNTER_H_INCLUDED
+#define GRISALLOCATIONCOUNTER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+//==============================================================================
+/** Heap allocation count of the calling thread.
+
+ The count only moves in executables that expand GRIS_DEFINE_ALLOCATION_COUNTING_OPERATORS
+ once, at file scope, in one of their translation units. Everywhere else isActive() is false.
+ */
+struct GrisAllocationCounter {
+    static long long& count(){
+        static thread_local long long numAllocations = 0;
+        return numAllocations;
+    }
+    static std::atomic<bool>& active(){
+        static std::atomic<bool> operatorsInstalled (false);
+        return operatorsInstalled;
+    }
+
+    static void increment()             { ++count(); }
+    static long long getCount()         { return count(); }
+    static bool isActive()              { return active().load (std::memory_order_relaxed); }
+
+    static void* allocate (std::size_t numBytes){
+        active().store (true, std::memory_order_relaxed);
+        increment();
+
+        if (void* p = std::malloc (numBytes != 0 ? numBytes : 1))
+            return p;
+
+        throw std::bad_alloc();
+    }
+};
+
+/** Replaces the global operator new/delete with versions that feed GrisAllocationCounter. */
+#define GRIS_DEFINE_ALLOCATION_COUNTING_OPERATORS \
+    void* operator new (std::size_t n)                                  { return GrisAllocationCounter::allocate (n); } \
+    void* operator new[] (std::size_t n)                                { return GrisAllocationCounter::allocate (n); } \
+    void* operator new (std::size_t n, const std::nothrow_t&) noexcept  { try { return GrisAllocationCounter::allocate (n); } catch (...) { return nullptr; } } \
+    void* operator new[] (std::size_t n, const std::nothrow_t&) noexcept{ try { return GrisAllocationCounter::allocate (n); } catch (...) { return nullptr; } } \
+    void operator delete (void* p) noexcept                             { std::free (p); } \
+    void operator delete[] (void* p) noexcept                           { std::free (p); } \
+    void operator delete (void* p, std::size_t) noexcept                { std::free (p); } \
+    void operator delete[] (void* p, std::size_t) noexcept              { std::free (p); }
+
+//==============================================================================
+/** Allocation figures of one draw override, gathered by GRIS_PAINT_ALLOCATION_CHECK. */
+struct GrisPaintAllocationStats {
+    GrisPaintAllocationStats (const char* overrideName, bool mustBeAllocationFree)
+        : name (overrideName), mustNotAllocate (mustBeAllocationFree),
+          numCalls (0), numAllocatingCalls (0)
+    {
+        const SpinLock::ScopedLockType sl (getLock());
+        this->next = getFirst();
+        getFirst() = this;
+    }
+
+    /** Calls before this one are not checked, so that caches and renderer state can fill up. */
+    static const int numWarmUpCalls = 16;
+
+    const char* name;
+    bool mustNotAllocate;
+    // counted from any thread painting, e.g. the workers of a GrisTiledRenderer
+    std::atomic<int> numCalls, numAllocatingCalls;
+    GrisPaintAllocationStats* next;
+
+    /** Head of the list of every override that has been drawn at least once. */
+    static GrisPaintAllocationStats*& getFirst(){
+        static GrisPaintAllocationStats* first = nullptr;
+        return first;
+    }
+    static SpinLock& getLock(){
+        static SpinLock lock;
+        return lock;
+    }
+};
+
+struct GrisPaintAllocationGuard {
+    explicit GrisPaintAllocationGuard (GrisPaintAllocationStats& s)
+        : stats (s), allocationsAtStart (GrisAllocationCounter::getCount()) {}
+
+    ~GrisPaintAllocationGuard(){
+        if (++this->stats.numCalls <= GrisPaintAllocationStats::numWarmUpCalls
+             || GrisAllocationCounter::getCount() == this->allocationsAtStart)
+            return;
+
+        ++this->stats.numAllocatingCalls;
+
+        // A GrisLookAndFeel draw call that should only fill rectangles allocated after warm-up.
+        jassert (! this->stats.mustNotAllocate);
+    }
+
+    GrisPaintAllocationStats& stats;
+    const long long allocationsAtStart;
+};
+
+/** Put at the top of a draw override. In debug builds it counts the calls that allocate
+    after warm-up and asserts if mustNotAllocate is true; in release builds it is empty.
+
+    Overrides that rasterise paths, images or glyphs pass false: the software renderer
+    allocates its own edge tables for those, so they are only counted.
+ */
+#if JUCE_DEBUG
+ #define GRIS_PAINT_ALLOCATION_CHECK(overrideName, mustNotAllocate) \
+    static GrisPaintAllocationStats grisPaintAllocationStats (overrideName, mustNotAllocate); \
+    const GrisPaintAllocationGuard grisPaintAllocationGuard (grisPaintAllocationStats)
+#else
+ #define GRIS_PAINT_ALLOCATION_CHECK(overrideName, mustNotAllocate)
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+/*
+ ==============================================================================
+
+ GrisDeltaSlider.h
+
+ A linear slider drawn like GrisLookAndFeel's, which only repaints the strip
+ between the previous and the new thumb position when its value changes.
+
+ ==============================================================================
+ */
+
+#ifndef GRISDELTASLIDER_H_INCLUDED
+#define GRISDELTASLIDER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+
+//==============================================================================
+/** A horizontal or vertical slider for values that are automated continuously.
+
+ A juce::Slider repaints its whole area on every value change. This one works out
+ where the thumb and the edge between the on and off parts of the track were and
+ where they are now, and only invalidates the strip between them; a change that
+ does not move anything by a pixel repaints nothing. Hover and press repaint the
+ thumb alone.
+
+ The track and thumb come from GrisLookAndFeel::getLinearSliderTrackBounds() and
+ getLinearSliderThumbBounds(), which drawLinearSliderBackground() and
+ drawLinearSliderThumb() use, for the slider area a juce::Slider of the same size
+ would give them. A vertical thumb reaches down the track as the look and feel's
+ does, so a vertical slider repaints from the higher of the two thumb positions
+ downwards. There is no
+ text box: pair it with a label, or with a numeric readout, when the value must be
+ shown.
+ */
+class GrisDeltaSlider : public Component, private AsyncUpdater {
+public:
+    class Listener {
+    public:
+        virtual ~Listener() {}
+        virtual void deltaSliderValueChanged (GrisDeltaSlider* slider) = 0;
+    };
+
+    GrisDeltaSlider (GrisLookAndFeel& lookAndFeel, bool isVerticalSlider = false)
+        : lnf (lookAndFeel), vertical (isVerticalSlider),
+          minimum (0.0), maximum (1.0), interval (0.0), value (0.0)
+    {
+    }
+
+    void addListener (Listener* l)      { this->listeners.add (l); }
+    void removeListener (Listener* l)   { this->listeners.remove (l); }
+
+    void setRange (double newMinimum, double newMaximum, double newInterval = 0.0){
+        jassert (newMaximum > newMinimum);
+        this->minimum = newMinimum;
+        this->maximum = newMaximum;
+        this->interval = newInterval;
+        this->value = constrain (this->value);
+        repaint();
+    }
+
+    double getMinimum() const noexcept  { return this->minimum; }
+    double getMaximum() const noexcept  { return this->maximum; }
+    double getValue() const noexcept    { return this->value; }
+    bool isVertical() const noexcept    { return this->vertical; }
+
+    void setValue (double newValue, NotificationType notification = sendNotificationAsync){
+        newValue = constrain (newValue);
+
+        if (newValue == this->value)
+            return;
+
+        const Rectangle<int> dirty (getRepaintArea (this->value, newValue));
+        this->value = newValue;
+
+        if (! dirty.isEmpty())
+            repaint (dirty);
+
+        if (notification == sendNotificationSync)
+            this->listeners.call (&Listener::deltaSliderValueChanged, this);
+        else if (notification != dontSendNotification)
+            triggerAsyncUpdate();
+    }
+
+    /** The area that must be repainted when the value goes from oldValue to newValue. */
+    Rectangle<int> getRepaintArea (double oldValue, double newValue) const{
+        const Range<float> before (getMovingExtent (oldValue));
+        const Range<float> after (getMovingExtent (newValue));
+
+        if (before == after)
+            return Rectangle<int>();
+
+        const int start = (int) std::floor (jmin (before.getStart(), after.getStart())) - 1;
+        const int end = (int) std::ceil (jmax (before.getEnd(), after.getEnd())) + 1;
+
+        return this->vertical ? Rectangle<int> (0, start, getWidth(), end - start).getIntersection (getLocalBounds())
+                              : Rectangle<int> (start, 0, end - start, getHeight()).getIntersection (getLocalBounds());
+    }
+
+    void paint (Graphics& g) override{
+        const float proportion = getProportion (this->value);
+        const Rectangle<float> track (getTrackBounds());
+        Rectangle<float> on (track), off (track);
+
+        if (this->vertical)
+            on = off.removeFromBottom (track.getHeight() * proportion);
+        else
+            on = off.removeFromLeft (track.getWidth() * proportion);
+
+        if (isEnabled()){
+            g.setColour (this->lnf.findColour (Slider::rotarySliderFillColourId));
+            g.fillRect (on);
+            g.setColour (this->lnf.findColour (Slider::trackColourId));
+            g.fillRect (off);
+        }else{
+            g.setColour (this->lnf.getOffColour());
+            g.fillRect (track);
+        }
+
+        const GrisTheme::State state = GrisTheme::getState (isEnabled(), false, isMouseOver(), isMouseButtonDown());
+        g.setColour (this->lnf.getTheme().getColour (GrisTheme::linearSliderThumb, state));
+        g.fillRect (getThumbBounds (getThumbPosition (this->value)));
+    }
+
+    void enablementChanged() override               { repaint(); }
+
+    void mouseEnter (const MouseEvent&) override    { repaintThumb(); }
+    void mouseExit (const MouseEvent&) override     { repaintThumb(); }
+    void mouseUp (const MouseEvent&) override       { repaintThumb(); }
+
+    void mouseDown (const MouseEvent& e) override{
+        repaintThumb();
+        mouseDrag (e);
+    }
+
+    void mouseDrag (const MouseEvent& e) override{
+        if (isEnabled())
+            setValue (positionToValue (this->vertical ? (float) e.y : (float) e.x), sendNotificationSync);
+    }
+
+private:
+    int getThumbRadius() const{
+        return GrisLookAndFeel::getLinearSliderThumbRadius (getWidth(), getHeight());
+    }
+
+    float getProportion (double v) const{
+        return (float) ((v - this->minimum) / (this->maximum - this->minimum));
+    }
+
+    float getLength() const{
+        return (float) jmax (0, (this->vertical ? getHeight() : getWidth()) - 2 * getThumbRadius());
+    }
+
+    /** Where a juce::Slider of the same size would put sliderPos for this value. */
+    float getThumbPosition (double v) const{
+        const float radius = (float) getThumbRadius();
+        return this->vertical ? getHeight() - radius - getProportion (v) * getLength()
+                              : radius + getProportion (v) * getLength();
+    }
+
+    double positionToValue (float position) const{
+        const float radius = (float) getThumbRadius();
+        const float proportion = this->vertical ? (getHeight() - radius - position) / jmax (1.0f, getLength())
+                                                : (position - radius) / jmax (1.0f, getLength());
+        return this->minimum + jlimit (0.0f, 1.0f, proportion) * (this->maximum - this->minimum);
+    }
+
+    /** The area a juce::Slider of this size passes to drawLinearSlider(): inset by the thumb
+        radius along its length, and 2 pixels taller, as drawLinearSlider() adds them.
+     */
+    Rectangle<int> getSliderArea() const{
+        const int radius = getThumbRadius();
+        const int length = (int) getLength();
+
+        return this->vertical ? Rectangle<int> (0, radius, getWidth(), length + 2)
+                              : Rectangle<int> (radius, 0, length, getHeight() + 2);
+    }
+
+    Rectangle<float> getTrackBounds() const{
+        const Rectangle<int> area (getSliderArea());
+        return GrisLookAndFeel::getLinearSliderTrackBounds (! this->vertical, area.getX(), area.getY(),
+                                                            area.getWidth(), area.getHeight(), getThumbRadius());
+    }
+
+    Rectangle<float> getThumbBounds (float position) const{
+        const Rectangle<int> area (getSliderArea());
+        return GrisLookAndFeel::getLinearSliderThumbBounds (! this->vertical, area.getX(), area.getY(),
+                                                            area.getWidth(), area.getHeight(), position, getThumbRadius());
+    }
+
+    /** Span, along the slider, of the thumb and of the on/off edge of the track for a value. */
+    Range<float> getMovingExtent (double v) const{
+        const Rectangle<float> thumb (getThumbBounds (getThumbPosition (v)));
+        const Rectangle<float> track (getTrackBounds());
+        const float edge = this->vertical ? track.getBottom() - track.getHeight() * getProportion (v)
+                                          : track.getX() + track.getWidth() * getProportion (v);
+        const Range<float> thumbRange (this->vertical ? thumb.getY() : thumb.getX(),
+                                       this->vertical ? thumb.getBottom() : thumb.getRight());
+
+        // snapped to pixels so that sub-pixel moves are recognised as no change
+        return Range<float> (std::floor (jmin (thumbRange.getStart(), edge)), std::ceil (jmax (thumbRange.getEnd(), edge)));
+    }
+
+    void repaintThumb(){
+        const Range<float> r (getMovingExtent (this->value));
+        const int start = (int) r.getStart() - 1;
+        const int length = (int) r.getLength() + 2;
+        repaint (this->vertical ? Rectangle<int> (0, start, getWidth(), length)
+                                : Rectangle<int> (start, 0, length, getHeight()));
+    }
+
+    double constrain (double v) const{
+        if (this->interval > 0.0)
+            v = this->minimum + this->interval * std::floor ((v - this->minimum) / this->interval + 0.5);
+
+        return jlimit (this->minimum, this->maximum, v);
+    }
+
+    void handleAsyncUpdate() override{
+        this->listeners.call (&Listener::deltaSliderValueChanged, this);
+    }
+
+    GrisLookAndFeel& lnf;
+    const bool vertical;
+    double minimum, maximum, interval, value;
+    ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisDeltaSlider)
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ ==============================================================================
+
+ GrisFieldRenderer.h
+
+ Draws the sources and speakers of a spatialisation view in one pass, as
+ instances of the GrisLookAndFeel round thumb sprite.
+
+ ==============================================================================
+ */
+
+#ifndef GRISFIELDRENDERER_H_INCLUDED
+#define GRISFIELDRENDERER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+/** Positions of a set of markers, one array per coordinate so that they can be
+ transformed with FloatVectorOperations.
+
+ Coordinates are in the unit the view chooses, e.g. -1 to 1 for a dome. Each
+ marker also has a kind, which chooses its colour when drawn.
+ */
+class GrisFieldPoints {
+public:
+    enum Kind { source = 0, speaker, selected, muted, numKinds };
+
+    explicit GrisFieldPoints (int maxNumPoints)
+        : capacity (jmax (1, maxNumPoints)), numPoints (0),
+          x ((size_t) capacity, true), y ((size_t) capacity, true), z ((size_t) capacity, true),
+          kinds ((size_t) capacity, true)
+    {
+    }
+
+    int getCapacity() const noexcept    { return this->capacity; }
+    int getNumPoints() const noexcept   { return this->numPoints; }
+
+    void setNumPoints (int newNumPoints) noexcept{
+        jassert (newNumPoints <= this->capacity);
+        this->numPoints = jlimit (0, this->capacity, newNumPoints);
+    }
+
+    void setPoint (int index, float px, float py, float pz, Kind kind) noexcept{
+        jassert (isPositiveAndBelow (index, this->capacity));
+        this->x[index] = px;
+        this->y[index] = py;
+        this->z[index] = pz;
+        this->kinds[index] = (uint8) kind;
+    }
+
+    void setKind (int index, Kind kind) noexcept    { this->kinds[index] = (uint8) kind; }
+
+    float* getX() noexcept                  { return this->x; }
+    float* getY() noexcept                  { return this->y; }
+    float* getZ() noexcept                  { return this->z; }
+    const float* getX() const noexcept      { return this->x; }
+    const float* getY() const noexcept      { return this->y; }
+    const float* getZ() const noexcept      { return this->z; }
+    Kind getKind (int index) const noexcept { return (Kind) this->kinds[index]; }
+
+private:
+    const int capacity;
+    int numPoints;
+    HeapBlock<float> x, y, z;
+    HeapBlock<uint8> kinds;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisFieldPoints)
+};
+
+//==============================================================================
+/** Rotates and projects GrisFieldPoints onto a view, culls the markers that fall
+ outside the clip region and draws the others back to front.
+
+ The projection is orthographic: the points are rotated by the view azimuth and
+ elevation, then x and y are scaled to the viewport, with FloatVectorOperations
+ doing the arithmetic on whole arrays. Markers are blits of the round thumb
+ sprite of the look and feel, one sprite per kind, in the colours of its theme:
+ on for sources, light for speakers, onOver for selected and off for muted ones.
+
+ Buffers grow to the largest point set seen, so drawing a field of unchanged size
+ does not allocate in the renderer itself.
+ */
+class GrisFieldRenderer {
+public:
+    explicit GrisFieldRenderer (GrisLookAndFeel& lookAndFeel)
+        : lnf (lookAndFeel), azimuth (0.0f), elevation (0.0f), zoom (1.0f),
+          markerDiameter (12.0f), outlineThickness (1.0f), numProjected (0), numVisible (0)
+    {
+    }
+
+    /** Azimuth turns around the vertical axis, elevation tilts the view; both in radians. */
+    void setViewAngles (float newAzimuth, float newElevation) noexcept{
+        this->azimuth = newAzimuth;
+        this->elevation = newElevation;
+    }
+
+    /** 1 fits the range -1 to 1 in the smaller side of the viewport. */
+    void setZoom (float newZoom) noexcept               { this->zoom = newZoom; }
+    void setMarkerDiameter (float diameter) noexcept    { this->markerDiameter = diameter; }
+    void setOutlineThickness (float thickness) noexcept { this->outlineThickness = thickness; }
+
+    /** Computes the screen position and depth of every point, for a viewport in component coordinates.
+        Depth grows toward the viewer.
+     */
+    void project (const GrisFieldPoints& points, const Rectangle<float>& viewport){
+        const int n = points.getNumPoints();
+        ensureCapacity (n);
+
+        const float ca = std::cos (this->azimuth), sa = std::sin (this->azimuth);
+        const float ce = std::cos (this->elevation), se = std::sin (this->elevation);
+        const float s = this->zoom * jmin (viewport.getWidth(), viewport.getHeight()) * 0.5f;
+
+        // screen x = x.ca - y.sa ; screen y = -((x.sa + y.ca).se + z.ce) ; depth = z.se - (x.sa + y.ca).ce
+        FloatVectorOperations::copyWithMultiply (this->screenX.data(), points.getX(), ca * s, n);
+        FloatVectorOperations::addWithMultiply (this->screenX.data(), points.getY(), -sa * s, n);
+        FloatVectorOperations::add (this->screenX.data(), viewport.getCentreX(), n);
+
+        FloatVectorOperations::copyWithMultiply (this->screenY.data(), points.getX(), -sa * se * s, n);
+        FloatVectorOperations::addWithMultiply (this->screenY.data(), points.getY(), -ca * se * s, n);
+        FloatVectorOperations::addWithMultiply (this->screenY.data(), points.getZ(), -ce * s, n);
+        FloatVectorOperations::add (this->screenY.data(), viewport.getCentreY(), n);
+
+        FloatVectorOperations::copyWithMultiply (this->depth.data(), points.getX(), -sa * ce, n);
+        FloatVectorOperations::addWithMultiply (this->depth.data(), points.getY(), -ca * ce, n);
+        FloatVectorOperations::addWithMultiply (this->depth.data(), points.getZ(), se, n);
+
+        this->numProjected = n;
+    }
+
+    /** Draws the markers last projected that touch the clip region. */
+    void draw (Graphics& g, const GrisFieldPoints& points){
+        jassert (points.getNumPoints() == this->numProjected);
+
+        const Rectangle<float> clip (g.getClipBounds().toFloat().expanded (this->markerDiameter * 0.5f + 2.0f));
+        this->numVisible = 0;
+
+        for (int i = 0; i < this->numProjected; ++i)
+            if (clip.contains (this->screenX[(size_t) i], this->screenY[(size_t) i]))
+                this->visible[(size_t) this->numVisible++] = i;
+
+        // farthest, i.e. smallest depth, first so that the nearest markers end up on top
+        const float* d = this->depth.data();
+        std::sort (this->visible.begin(), this->visible.begin() + this->numVisible,
+                   [d] (int a, int b) { return d[a] < d[b]; });
+
+        const GrisTheme& t = this->lnf.getTheme();
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const Colour colours[GrisFieldPoints::numKinds] = { t.on, t.light, t.onOver, t.off };
+        Image sprites[GrisFieldPoints::numKinds];
+
+        for (int k = 0; k < GrisFieldPoints::numKinds; ++k)
+            sprites[k] = this->lnf.getRoundThumbSprite (t, this->markerDiameter, colours[k], this->outlineThickness, scale);
+
+        const float offset = this->markerDiameter * 0.5f + GrisLookAndFeel::getRoundThumbSpriteMargin();
+
+        for (int v = 0; v < this->numVisible; ++v){
+            const int i = this->visible[(size_t) v];
+            const Image& sprite = sprites[points.getKind (i)];
+
+            if (scale == 1.0f)
+                g.drawImageAt (sprite, roundToInt (this->screenX[(size_t) i] - offset), roundToInt (this->screenY[(size_t) i] - offset));
+            else
+                g.drawImageTransformed (sprite, AffineTransform::scale (1.0f / scale)
+                                                    .translated (this->screenX[(size_t) i] - offset, this->screenY[(size_t) i] - offset));
+        }
+    }
+
+    /** Number of markers drawn by the last draw(). */
+    int getNumVisible() const noexcept  { return this->numVisible; }
+
+    /** The index of the point drawn at a position in the order of the last draw(), farthest first. */
+    int getVisiblePoint (int drawIndex) const noexcept{
+        jassert (isPositiveAndBelow (drawIndex, this->numVisible));
+        return this->visible[(size_t) drawIndex];
+    }
+
+    /** The index of the nearest marker whose disc contains a point, or -1. */
+    int getPointAt (Point<float> position) const{
+        const float radius = this->markerDiameter * 0.5f;
+        int best = -1;
+
+        for (int i = 0; i < this->numProjected; ++i){
+            const float dx = this->screenX[(size_t) i] - position.x;
+            const float dy = this->screenY[(size_t) i] - position.y;
+
+            if (dx * dx + dy * dy <= radius * radius && (best < 0 || this->depth[(size_t) i] > this->depth[(size_t) best]))
+                best = i;
+        }
+
+        return best;
+    }
+
+    Point<float> getScreenPosition (int index) const{
+        return Point<float> (this->screenX[(size_t) index], this->screenY[(size_t) index]);
+    }
+
+private:
+    void ensureCapacity (int n){
+        if ((int) this->screenX.size() < n){
+            this->screenX.resize ((size_t) n);
+            this->screenY.resize ((size_t) n);
+            this->depth.resize ((size_t) n);
+            this->visible.resize ((size_t) n);
+        }
+    }
+
+    GrisLookAndFeel& lnf;
+    float azimuth, elevation, zoom;
+    float markerDiameter, outlineThickness;
+    std::vector<float> screenX, screenY, depth;
+    std::vector<int> visible;
+    int numProjected, numVisible;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisFieldRenderer)
+};
+
+#endif
@@ -0,0 +1,282 @@
+/*
+ ==============================================================================
+
+ GrisFonts.h
+
+ Process-wide access to the typefaces embedded in the GRIS plugins, so that
+ every instance of a plugin shares a single parsed copy of each font.
+
+ ==============================================================================
+ */
+
+#ifndef GRISFONTS_H_INCLUDED
+#define GRISFONTS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisWorkerPool.h"
+
+//==============================================================================
+/** The typefaces embedded in BinaryData, parsed on first use.
+
+ Hold it through a SharedResourcePointer<GrisSharedTypeface>: each embedded font
+ is parsed once per process, by the first caller that asks for it, and every
+ typeface is released when the last holder goes away.
+
+ A resource is looked up by its BinaryData name (e.g. "SinkinSans400Regular_otf").
+ When a gzipped subset made by Fonts/build_font_subsets.sh is embedded instead
+ ("SinkinSans400Regular_otf_gz"), it is inflated at that point, so unused weights
+ never cost more than their compressed bytes.
+ */
+class GrisSharedTypeface {
+public:
+    GrisSharedTypeface() {}
+
+    /** The Sinkin Sans regular face used by GrisLookAndFeel. */
+    Typeface::Ptr getTypeface(){
+        return getTypeface ("SinkinSans400Regular_otf");
+    }
+
+    Typeface::Ptr getTypeface (const String& resourceName){
+        const ScopedLock sl (this->lock);
+
+        if (this->typefaces.contains (resourceName))
+            return this->typefaces[resourceName];
+
+        const int64 start = Time::getHighResolutionTicks();
+        MemoryBlock fontData;
+        Typeface::Ptr typeface;
+
+        if (loadResource (resourceName, fontData)){
+            typeface = CustomTypeface::createSystemTypefaceFor (fontData.getData(), fontData.getSize());
+            this->dataHashes.set (resourceName, (int64) hashBytes (fontData));
+        }
+
+        // a font resource missing from BinaryData
+        jassert (typeface != nullptr);
+
+        ++getNumLoads();
+        getLastLoadSeconds() = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+        this->typefaces.set (resourceName, typeface);
+        return typeface;
+    }
+
+    /** A 64 bit FNV-1a hash of the uncompressed font file, 0 if it could not be loaded.
+        Used to tell whether data derived from a font, such as a glyph atlas, is still valid.
+     */
+    uint64 getDataHash (const String& resourceName = "SinkinSans400Regular_otf"){
+        getTypeface (resourceName);
+        const ScopedLock sl (this->lock);
+        return (uint64) this->dataHashes[resourceName];
+    }
+
+    /** Number of embedded fonts parsed since the process started. */
+    static int& getNumLoads(){
+        static int numLoads = 0;
+        return numLoads;
+    }
+    static double& getLastLoadSeconds(){
+        static double seconds = 0.0;
+        return seconds;
+    }
+
+private:
+    static uint64 hashBytes (const MemoryBlock& data) noexcept{
+        uint64 hash = 14695981039346656037ULL;
+        const uint8* bytes = static_cast<const uint8*> (data.getData());
+
+        for (size_t i = 0; i < data.getSize(); ++i){
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    static bool loadResource (const String& resourceName, MemoryBlock& result){
+        int size = 0;
+
+        if (const char* compressed = BinaryData::getNamedResource ((resourceName + "_gz").toRawUTF8(), size)){
+            MemoryInputStream source (compressed, (size_t) size, false);
+            GZIPDecompressorInputStream inflater (&source, false, GZIPDecompressorInputStream::gzipFormat);
+            inflater.readIntoMemoryBlock (result);
+            return result.getSize() > 0;
+        }
+
+        if (const char* raw = BinaryData::getNamedResource (resourceName.toRawUTF8(), size)){
+            result.replaceWith (raw, (size_t) size);
+            return true;
+        }
+
+        return false;
+    }
+
+    CriticalSection lock;
+    HashMap<String, Typeface::Ptr> typefaces;
+    HashMap<String, int64> dataHashes;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisSharedTypeface)
+};
+
+//==============================================================================
+/** Font sizes used by GrisLookAndFeel.
+
+ Heights are given in logical pixels and snapped so that, at a given display
+ scale, glyphs are always rasterised at a whole number of physical pixels.
+ */
+struct GrisFontMetrics {
+    /** Height of labels, combo boxes, buttons and toggles. */
+    static float getBaseHeight() noexcept{
+       #if JUCE_WINDOWS
+        return 18.0f;
+       #else
+        return 10.0f;
+       #endif
+    }
+
+    /** Height of tab names, relative to the depth of the tab. */
+    static float getTabHeightRatio() noexcept{
+       #if JUCE_WINDOWS
+        return 0.60f;
+       #else
+        return 0.35f;
+       #endif
+    }
+
+    static float snapHeight (float logicalHeight, float scale) noexcept{
+        return jmax (1, roundToInt (logicalHeight * scale)) / scale;
+    }
+
+    /** Characters pre-rasterised for each size: what the GRIS UIs print, the degree
+        sign of azimuths and elevations included. UTF-8.
+     */
+    static const char* getWarmUpCharacters() noexcept{
+        return " !\"#%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[]_abcdefghijklmnopqrstuvwxyz|~\xc2\xb0";
+    }
+};
+
+//==============================================================================
+/** Renders a font's common glyphs once into a scratch image, so that the software
+ renderer's glyph cache already holds them when the UI first paints at that scale.
+ */
+class GrisGlyphWarmUpJob : public ThreadPoolJob {
+public:
+    GrisGlyphWarmUpJob (const Font& fontToWarm, float scaleToWarm)
+        : ThreadPoolJob ("GRIS glyph warm-up"), font (fontToWarm), scale (scaleToWarm) {}
+
+    JobStatus runJob() override{
+        const String text (String::fromUTF8 (GrisFontMetrics::getWarmUpCharacters()));
+        const int width = jmax (1, roundToInt (this->font.getStringWidthFloat (text) * this->scale) + 2);
+        const int height = jmax (1, roundToInt (this->font.getHeight() * this->scale) + 2);
+
+        Image scratch (Image::ARGB, width, height, true, SoftwareImageType());
+        Graphics g (scratch);
+        g.addTransform (AffineTransform::scale (this->scale));
+        g.setFont (this->font);
+        g.setColour (Colours::white);
+        g.drawSingleLineText (text, 0, roundToInt (this->font.getAscent()));
+
+        return jobHasFinished;
+    }
+
+private:
+    const Font font;
+    const float scale;
+};
+
+//==============================================================================
+/** The fonts of one look and feel for every display scale it has been drawn at.
+
+ Each scale gets its own snapped font the first time it is seen, and its glyphs
+ are warmed up on the shared GrisWorkerPool. Later scale changes only pick an
+ existing entry. Thread safe, so that GrisTiledRenderer workers can paint text;
+ entries are never removed, so the references returned stay valid.
+ */
+class GrisScaledFonts {
+public:
+    explicit GrisScaledFonts (const Font& baseFontToUse)
+        : baseFont (baseFontToUse) {}
+
+    /** The base font, snapped for this display scale. */
+    const Font& getFont (float scale){
+        const ScopedLock sl (this->lock);
+        return getEntry (scale).font;
+    }
+
+    /** Tab name font for a tab of the given depth. Each depth and underline state gets
+        its own font at each scale, made and warmed up the first time it is asked for,
+        so tab bars of different depths never rebuild each other's fonts.
+     */
+    const Font& getTabFont (float depth, bool underlined, float scale){
+        const ScopedLock sl (this->lock);
+        Entry& e = getEntry (scale);
+
+        for (int i = 0; i < e.tabFonts.size(); ++i){
+            const TabFont& t = *e.tabFonts.getUnchecked (i);
+
+            if (t.depth == depth && t.underlined == underlined)
+                return t.font;
+        }
+
+        TabFont* t = e.tabFonts.add (new TabFont());
+        t->depth = depth;
+        t->underlined = underlined;
+        t->font = this->baseFont.withHeight (GrisFontMetrics::snapHeight (depth * GrisFontMetrics::getTabHeightRatio(), e.scale));
+        t->font.setUnderline (underlined);
+        warmUp (t->font, e.scale);
+
+        return t->font;
+    }
+
+    int getNumScales() const noexcept { return this->entries.size(); }
+
+private:
+    struct TabFont {
+        float depth;
+        bool underlined;
+        Font font;
+    };
+
+    struct Entry {
+        float scale;
+        Font font;
+        OwnedArray<TabFont> tabFonts;
+    };
+
+    Entry& getEntry (float scale){
+        scale = jmax (0.25f, roundToInt (scale * 100.0f) / 100.0f);
+
+        if (this->current != nullptr && this->current->scale == scale)
+            return *this->current;
+
+        for (int i = 0; i < this->entries.size(); ++i){
+            if (this->entries.getUnchecked (i)->scale == scale){
+                this->current = this->entries.getUnchecked (i);
+                return *this->current;
+            }
+        }
+
+        Entry* e = new Entry();
+        e->scale = scale;
+        e->font = this->baseFont.withHeight (GrisFontMetrics::snapHeight (this->baseFont.getHeight(), scale));
+        this->entries.add (e);
+        this->current = e;
+
+        warmUp (e->font, scale);
+        return *e;
+    }
+
+    void warmUp (const Font& f, float scale){
+        this->workers->getPool().addJob (new GrisGlyphWarmUpJob (f, scale), true);
+    }
+
+    const Font baseFont;
+    CriticalSection lock;
+    OwnedArray<Entry> entries;
+    Entry* current = nullptr;
+    SharedResourcePointer<GrisWorkerPool> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisScaledFonts)
+};
+
+#endif
@@ -0,0 +1,543 @@
+/*
+ ==============================================================================
+
+ GrisGlyphAtlas.h
+
+ Pre-rasterised glyphs of a font at one size and display scale, kept in a
+ file so that later sessions map them instead of rasterising them again.
+
+ ==============================================================================
+ */
+
+#ifndef GRISGLYPHATLAS_H_INCLUDED
+#define GRISGLYPHATLAS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisFonts.h"
+
+//==============================================================================
+/** One alpha image holding the glyphs of GrisFontMetrics::getWarmUpCharacters()
+ for a font, a height and a display scale, with their metrics.
+
+ An atlas either owns its image, when it has just been rasterised, or reads its
+ pixels straight from a read-only memory mapped cache file; glyph images are
+ sub-images of that single image in both cases, so drawing never copies them.
+ Atlases are immutable once made and are shared through GrisGlyphAtlasCache.
+ */
+class GrisGlyphAtlas : public ReferenceCountedObject {
+public:
+    typedef ReferenceCountedObjectPtr<GrisGlyphAtlas> Ptr;
+
+    /** Placement of a glyph in the atlas, in physical pixels. Offsets are from the pen
+        position on the baseline to the top left of the glyph image.
+     */
+    struct Glyph {
+        int32 character;
+        int16 x, y, width, height;
+        float xOffset, yOffset, advance;
+    };
+
+    float getHeight() const noexcept    { return this->header.height; }
+    float getScale() const noexcept     { return this->header.scale; }
+    uint64 getFontHash() const noexcept { return this->header.fontHash; }
+    int getNumGlyphs() const noexcept   { return this->header.numGlyphs; }
+
+    /** Ascent of the font in logical pixels. */
+    float getAscent() const noexcept    { return this->header.ascent / this->header.scale; }
+
+    /** True when the pixels are read from a mapped cache file rather than held in memory. */
+    bool isMapped() const noexcept      { return this->mappedFile != nullptr; }
+
+    /** The glyph of a character, or nullptr when it is not in the atlas. Only characters
+        below numIndexedCharacters can be, i.e. ASCII and Latin-1 such as the degree sign.
+     */
+    const Glyph* findGlyph (juce_wchar c) const noexcept{
+        if (! isPositiveAndBelow ((int) c, (int) numIndexedCharacters) || this->indexOf[c] < 0)
+            return nullptr;
+
+        return this->glyphs + this->indexOf[c];
+    }
+
+    /** True if every character of the UTF-8 text has a glyph in the atlas. */
+    bool canDraw (const char* text) const noexcept{
+        for (CharPointer_UTF8 t (text); ! t.isEmpty();)
+            if (findGlyph (t.getAndAdvance()) == nullptr)
+                return false;
+
+        return true;
+    }
+
+    /** Width of the UTF-8 text in logical pixels. */
+    float getStringWidth (const char* text) const noexcept{
+        float width = 0.0f;
+
+        for (CharPointer_UTF8 t (text); ! t.isEmpty();)
+            if (const Glyph* glyph = findGlyph (t.getAndAdvance()))
+                width += glyph->advance;
+
+        return width / this->header.scale;
+    }
+
+    /** Blits the UTF-8 text with the current colour of g, the baseline starting at
+        (x, baselineY) in logical pixels. Characters missing from the atlas are skipped.
+        Returns the x position after the last character.
+     */
+    float drawText (Graphics& g, const char* text, float x, float baselineY) const{
+        for (CharPointer_UTF8 t (text); ! t.isEmpty();)
+            if (const Glyph* glyph = findGlyph (t.getAndAdvance()))
+                x = drawGlyph (g, *glyph, x, baselineY);
+
+        return x;
+    }
+
+    /** Blits one glyph of this atlas like drawText() does, and returns the x position after it. */
+    float drawGlyph (Graphics& g, const Glyph& glyph, float x, float baselineY) const{
+        const float scale = this->header.scale;
+        const float pen = x * scale;
+        const float baseline = baselineY * scale;
+        const Image& image = this->glyphImages.getReference ((int) (&glyph - this->glyphs));
+
+        if (image.isValid()){
+            if (scale == 1.0f)
+                g.drawImageAt (image, roundToInt (pen + glyph.xOffset), roundToInt (baseline + glyph.yOffset), true);
+            else
+                g.drawImageTransformed (image, AffineTransform::translation ((float) roundToInt (pen + glyph.xOffset),
+                                                                             (float) roundToInt (baseline + glyph.yOffset))
+                                                               .scaled (1.0f / scale), true);
+        }
+
+        return x + glyph.advance / scale;
+    }
+
+    //==============================================================================
+    enum { fileMagic = 0x41475247 /* "GRGA" */, fileVersion = 3, atlasWidth = 512, padding = 1 };
+    enum { numIndexedCharacters = 256 };
+
+    struct FileHeader {
+        uint32 magic, version;
+        uint64 fontHash;
+        float height, scale;
+        int32 numGlyphs, imageWidth, imageHeight, lineStride;
+        float ascent;
+        uint32 reserved;
+        uint64 payloadHash;
+    };
+
+    /** Rasterises the atlas of a font; its height is taken in logical pixels. */
+    static Ptr build (const Font& font, uint64 fontHash, float scale){
+        const Font physicalFont (font.withHeight (font.getHeight() * scale));
+        const String characters (String::fromUTF8 (GrisFontMetrics::getWarmUpCharacters()));
+
+        Ptr atlas (new GrisGlyphAtlas());
+        FileHeader& h = atlas->header;
+        h.magic = fileMagic;
+        h.version = fileVersion;
+        h.fontHash = fontHash;
+        h.height = font.getHeight();
+        h.scale = scale;
+        h.ascent = physicalFont.getAscent();
+        h.reserved = 0;
+
+        atlas->ownedGlyphs.calloc ((size_t) characters.length());
+        atlas->glyphs = atlas->ownedGlyphs;
+
+        // shelf packing: glyphs left to right, a new row when the current one is full
+        int x = 0, y = 0, rowHeight = 0, numGlyphs = 0;
+
+        for (int i = 0; i < characters.length(); ++i){
+            GlyphArrangement ga;
+            ga.addLineOfText (physicalFont, characters.substring (i, i + 1), 0.0f, 0.0f);
+
+            if (ga.getNumGlyphs() != 1)
+                continue;
+
+            // cells hold the ink of the outline, which may overhang the advance or the line box
+            const PositionedGlyph& pg = ga.getGlyph (0);
+            Path outline;
+            pg.createPath (outline);
+            const Rectangle<int> b (outline.getBounds().getSmallestIntegerContainer());
+            const int w = b.isEmpty() ? 0 : b.getWidth() + 2 * padding;
+            const int gh = b.isEmpty() ? 0 : b.getHeight() + 2 * padding;
+
+            if (x + w > atlasWidth){
+                x = 0;
+                y += rowHeight;
+                rowHeight = 0;
+            }
+
+            Glyph& glyph = atlas->ownedGlyphs[numGlyphs++];
+            glyph.character = (int32) characters[i];
+            glyph.x = (int16) x;
+            glyph.y = (int16) y;
+            glyph.width = (int16) w;
+            glyph.height = (int16) gh;
+            glyph.xOffset = (float) (b.getX() - padding);
+            glyph.yOffset = (float) (b.getY() - padding);
+            glyph.advance = pg.getRight() - pg.getLeft();
+
+            x += w;
+            rowHeight = jmax (rowHeight, gh);
+        }
+
+        h.numGlyphs = numGlyphs;
+        h.imageWidth = atlasWidth;
+        h.imageHeight = jmax (1, y + rowHeight);
+
+        atlas->image = Image (Image::SingleChannel, h.imageWidth, h.imageHeight, true, SoftwareImageType());
+
+        {
+            Graphics g (atlas->image);
+            g.setColour (Colours::white);
+
+            for (int i = 0; i < numGlyphs; ++i){
+                const Glyph& glyph = atlas->glyphs[i];
+                GlyphArrangement ga;
+                ga.addLineOfText (physicalFont, String::charToString ((juce_wchar) glyph.character),
+                                  glyph.x - glyph.xOffset, glyph.y - glyph.yOffset);
+                ga.draw (g);
+            }
+        }
+
+        const Image::BitmapData pixels (atlas->image, Image::BitmapData::readOnly);
+        h.lineStride = pixels.lineStride;
+        h.payloadHash = hashPayload (atlas->glyphs, numGlyphs, pixels.data, (size_t) pixels.lineStride * (size_t) h.imageHeight);
+
+        atlas->createGlyphImages();
+        return atlas;
+    }
+
+    /** Maps a cache file written by writeTo(); returns nullptr when it is missing,
+        truncated, corrupt, or made for another font, height or scale.
+     */
+    static Ptr load (const File& file, uint64 fontHash, float height, float scale){
+        std::unique_ptr<MemoryMappedFile> mapped (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+        const size_t size = mapped->getSize();
+
+        if (mapped->getData() == nullptr || size < sizeof (FileHeader))
+            return nullptr;
+
+        const char* data = static_cast<const char*> (mapped->getData());
+        FileHeader h;
+        memcpy (&h, data, sizeof (h));
+
+        if (h.magic != fileMagic || h.version != fileVersion || h.fontHash != fontHash
+             || h.height != height || h.scale != scale
+             || h.numGlyphs < 0 || h.numGlyphs > 1024 || h.imageWidth <= 0 || h.imageHeight <= 0
+             || h.lineStride < h.imageWidth)
+            return nullptr;
+
+        const size_t glyphBytes = sizeof (Glyph) * (size_t) h.numGlyphs;
+        const size_t pixelBytes = (size_t) h.lineStride * (size_t) h.imageHeight;
+
+        if (size != sizeof (FileHeader) + glyphBytes + pixelBytes)
+            return nullptr;
+
+        const Glyph* glyphs = reinterpret_cast<const Glyph*> (data + sizeof (FileHeader));
+        const uint8* pixels = reinterpret_cast<const uint8*> (data + sizeof (FileHeader) + glyphBytes);
+
+        if (hashPayload (glyphs, h.numGlyphs, pixels, pixelBytes) != h.payloadHash)
+            return nullptr;
+
+        for (int i = 0; i < h.numGlyphs; ++i)
+            if (glyphs[i].x < 0 || glyphs[i].y < 0 || glyphs[i].x + glyphs[i].width > h.imageWidth
+                 || glyphs[i].y + glyphs[i].height > h.imageHeight)
+                return nullptr;
+
+        Ptr atlas (new GrisGlyphAtlas());
+        atlas->header = h;
+        atlas->glyphs = glyphs;
+        atlas->image = Image (new MappedPixelData (pixels, h.imageWidth, h.imageHeight, h.lineStride));
+        atlas->mappedFile = std::move (mapped);
+        atlas->createGlyphImages();
+        return atlas;
+    }
+
+    /** Writes the atlas next to the target first and then moves it in place, so that
+        another process never maps a half written file.
+     */
+    bool writeTo (const File& file) const{
+        if (! file.getParentDirectory().createDirectory())
+            return false;
+
+        TemporaryFile temp (file);
+
+        {
+            FileOutputStream out (temp.getFile());
+
+            if (out.failedToOpen())
+                return false;
+
+            const Image::BitmapData pixels (this->image, Image::BitmapData::readOnly);
+            out.write (&this->header, sizeof (FileHeader));
+            out.write (this->glyphs, sizeof (Glyph) * (size_t) this->header.numGlyphs);
+            out.write (pixels.data, (size_t) this->header.lineStride * (size_t) this->header.imageHeight);
+            out.flush();
+
+            if (out.getStatus().failed())
+                return false;
+        }
+
+        return temp.overwriteTargetFileWithTemporary();
+    }
+
+private:
+    GrisGlyphAtlas() : glyphs (nullptr){
+        for (int i = 0; i < numIndexedCharacters; ++i)
+            this->indexOf[i] = -1;
+    }
+
+    /** Read-only pixels of the mapped file. The atlas owns the mapping and never hands
+        out its images, so they cannot outlive it.
+     */
+    class MappedPixelData : public ImagePixelData {
+    public:
+        MappedPixelData (const uint8* pixelsToUse, int w, int h, int stride)
+            : ImagePixelData (Image::SingleChannel, w, h), pixels (pixelsToUse), lineStride (stride) {}
+
+       #if JUCE_MAJOR_VERSION >= 6
+        std::unique_ptr<LowLevelGraphicsContext> createLowLevelContext() override{
+            jassertfalse; // the atlas is read only
+            return nullptr;
+        }
+        std::unique_ptr<ImageType> createType() const override  { return std::make_unique<SoftwareImageType>(); }
+       #else
+        LowLevelGraphicsContext* createLowLevelContext() override{
+            jassertfalse; // the atlas is read only
+            return nullptr;
+        }
+        ImageType* createType() const override                  { return new SoftwareImageType(); }
+       #endif
+
+        void initialiseBitmapData (Image::BitmapData& bitmap, int x, int y, Image::BitmapData::ReadWriteMode mode) override{
+            jassert (mode == Image::BitmapData::readOnly);
+            ignoreUnused (mode);
+            bitmap.data = const_cast<uint8*> (this->pixels) + x + y * this->lineStride;
+            bitmap.pixelFormat = Image::SingleChannel;
+            bitmap.lineStride = this->lineStride;
+            bitmap.pixelStride = 1;
+           #if JUCE_MAJOR_VERSION >= 6
+            bitmap.size = (size_t) (this->height - y) * (size_t) this->lineStride - (size_t) x;
+           #endif
+        }
+
+        ImagePixelData::Ptr clone() override{
+            Image copy (Image::SingleChannel, this->width, this->height, false, SoftwareImageType());
+            const Image::BitmapData dest (copy, Image::BitmapData::writeOnly);
+
+            for (int y = 0; y < this->height; ++y)
+                memcpy (dest.getLinePointer (y), this->pixels + y * this->lineStride, (size_t) this->width);
+
+            return copy.getPixelData();
+        }
+
+    private:
+        const uint8* pixels;
+        const int lineStride;
+    };
+
+    static uint64 hashPayload (const Glyph* glyphs, int numGlyphs, const uint8* pixels, size_t numPixelBytes) noexcept{
+        uint64 hash = 14695981039346656037ULL;
+        const uint8* bytes = reinterpret_cast<const uint8*> (glyphs);
+
+        for (size_t i = 0; i < sizeof (Glyph) * (size_t) numGlyphs; ++i)
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        for (size_t i = 0; i < numPixelBytes; ++i)
+            hash = (hash ^ pixels[i]) * 1099511628211ULL;
+
+        return hash;
+    }
+
+    void createGlyphImages(){
+        for (int i = 0; i < this->header.numGlyphs; ++i){
+            const Glyph& glyph = this->glyphs[i];
+
+            if (isPositiveAndBelow ((int) glyph.character, (int) numIndexedCharacters))
+                this->indexOf[glyph.character] = (int16) i;
+
+            this->glyphImages.add (glyph.width > 0 && glyph.height > 0
+                                     ? this->image.getClippedImage (Rectangle<int> (glyph.x, glyph.y, glyph.width, glyph.height))
+                                     : Image());
+        }
+    }
+
+    FileHeader header;
+    HeapBlock<Glyph> ownedGlyphs;
+    const Glyph* glyphs;
+    int16 indexOf[numIndexedCharacters];
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    Image image;
+    Array<Image> glyphImages;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisGlyphAtlas)
+};
+
+//==============================================================================
+/** The glyph atlases of a process, each mapped or built once and shared by every
+ plugin instance. Hold it through a SharedResourcePointer<GrisGlyphAtlasCache>.
+
+ Atlases live in getDefaultCacheDirectory() unless setCacheDirectory() picks another
+ one, one file per font hash, height and scale. A file that does not validate is
+ rebuilt and replaced; when the directory cannot be written the atlas is simply
+ kept in memory.
+
+ get() maps or builds an atlas on the calling thread. Painting code should rather
+ call find(), which never touches the disk, and prepare() the atlases it will need
+ so that they are made on the shared GrisWorkerPool.
+ */
+class GrisGlyphAtlasCache {
+public:
+    GrisGlyphAtlasCache()
+        : directory (getDefaultCacheDirectory()), numMapped (0), numBuilt (0), numRejected (0) {}
+
+    ~GrisGlyphAtlasCache(){
+        JobsOfCache jobs (*this);
+        this->workers->getPool().removeAllJobs (false, 10000, &jobs);
+    }
+
+    /** The atlas of a font at a scale, mapped from its file or built and written there first. */
+    GrisGlyphAtlas::Ptr get (const Font& font, uint64 fontHash, float scale){
+        const float height = font.getHeight();
+        const String name (getFileName (fontHash, height, scale));
+        File file;
+
+        {
+            const ScopedLock sl (this->lock);
+
+            if (this->atlases.contains (name))
+                return this->atlases[name];
+
+            file = this->directory.getChildFile (name);
+        }
+
+        // mapped or built without the lock, so that the atlases already made stay available;
+        // threads asking for the same new atlas at once may each make it, the first stored wins
+        GrisGlyphAtlas::Ptr atlas;
+        bool rejected = false;
+
+        if (file.existsAsFile()){
+            atlas = GrisGlyphAtlas::load (file, fontHash, height, scale);
+            rejected = atlas == nullptr;
+        }
+
+        const bool built = atlas == nullptr;
+
+        if (built){
+            atlas = GrisGlyphAtlas::build (font, fontHash, scale);
+
+            // map the file just written, so that the pixels are shared with other processes' page cache
+            if (atlas->writeTo (file))
+                if (GrisGlyphAtlas::Ptr mapped = GrisGlyphAtlas::load (file, fontHash, height, scale))
+                    atlas = mapped;
+        }
+
+        const ScopedLock sl (this->lock);
+        this->pending.removeString (name);
+
+        if (this->atlases.contains (name))
+            return this->atlases[name];
+
+        if (built)
+            ++this->numBuilt;
+        else
+            ++this->numMapped;
+
+        if (rejected)
+            ++this->numRejected;
+
+        this->atlases.set (name, atlas);
+        return atlas;
+    }
+
+    /** The atlas of a font at a scale if it is already in memory, or nullptr. Never blocks on the disk. */
+    GrisGlyphAtlas::Ptr find (uint64 fontHash, float height, float scale){
+        const ScopedLock sl (this->lock);
+        return this->atlases[getFileName (fontHash, height, scale)];
+    }
+
+    /** Queues get() on the shared GrisWorkerPool, unless the atlas is in memory or already queued. */
+    void prepare (const Font& font, uint64 fontHash, float scale){
+        const String name (getFileName (fontHash, font.getHeight(), scale));
+
+        {
+            const ScopedLock sl (this->lock);
+
+            if (this->atlases.contains (name) || this->pending.contains (name))
+                return;
+
+            this->pending.add (name);
+        }
+
+        this->workers->getPool().addJob (new PrepareJob (*this, font, fontHash, scale), true);
+    }
+
+    /** userApplicationDataDirectory/GRIS/GlyphAtlas */
+    static File getDefaultCacheDirectory(){
+        return File::getSpecialLocation (File::userApplicationDataDirectory).getChildFile ("GRIS").getChildFile ("GlyphAtlas");
+    }
+
+    /** Where atlases are looked for and written from now on, e.g. a temporary directory for
+        tests. Atlases already in memory are kept.
+     */
+    void setCacheDirectory (const File& newDirectory){
+        const ScopedLock sl (this->lock);
+        this->directory = newDirectory;
+    }
+
+    File getCacheDirectory() const{
+        const ScopedLock sl (this->lock);
+        return this->directory;
+    }
+
+    int getNumMapped() const noexcept   { return this->numMapped; }
+    int getNumBuilt() const noexcept    { return this->numBuilt; }
+
+    /** Cache files found stale or corrupt, and rebuilt. */
+    int getNumRejected() const noexcept { return this->numRejected; }
+
+private:
+    class PrepareJob : public ThreadPoolJob {
+    public:
+        PrepareJob (GrisGlyphAtlasCache& cacheToFill, const Font& fontToUse, uint64 hash, float scaleToUse)
+            : ThreadPoolJob ("GRIS glyph atlas"), cache (cacheToFill), font (fontToUse), fontHash (hash), scale (scaleToUse) {}
+
+        JobStatus runJob() override{
+            this->cache.get (this->font, this->fontHash, this->scale);
+            return jobHasFinished;
+        }
+
+        GrisGlyphAtlasCache& cache;
+
+    private:
+        const Font font;
+        const uint64 fontHash;
+        const float scale;
+    };
+
+    // the jobs of this cache, which must finish before it goes away
+    struct JobsOfCache : public ThreadPool::JobSelector {
+        explicit JobsOfCache (GrisGlyphAtlasCache& c) : cache (c) {}
+
+        bool isJobSuitable (ThreadPoolJob* job) override{
+            PrepareJob* p = dynamic_cast<PrepareJob*> (job);
+            return p != nullptr && &p->cache == &this->cache;
+        }
+
+        GrisGlyphAtlasCache& cache;
+    };
+
+    static String getFileName (uint64 fontHash, float height, float scale){
+        return String::toHexString ((int64) fontHash) + "_" + String (roundToInt (height * 100.0f))
+                + "_" + String (roundToInt (scale * 100.0f)) + ".v" + String ((int) GrisGlyphAtlas::fileVersion) + ".atlas";
+    }
+
+    CriticalSection lock;
+    HashMap<String, GrisGlyphAtlas::Ptr> atlases;
+    StringArray pending;
+    File directory;
+    int numMapped, numBuilt, numRejected;
+    SharedResourcePointer<GrisWorkerPool> workers;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisGlyphAtlasCache)
+};
+
+#endif
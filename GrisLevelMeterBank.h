@@ -0,0 +1,200 @@
+/*
+ ==============================================================================
+
+ GrisLevelMeterBank.h
+
+ A single component drawing the VU meters of many speakers or inputs.
+
+ ==============================================================================
+ */
+
+#ifndef GRISLEVELMETERBANK_H_INCLUDED
+#define GRISLEVELMETERBANK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/** Levels and peaks of a set of channels, written by the audio thread and read
+ by the message thread without locks.
+ */
+class GrisMeterLevels {
+public:
+    explicit GrisMeterLevels (int numChannelsToUse)
+        : numChannels (numChannelsToUse), levels ((size_t) numChannelsToUse), peaks ((size_t) numChannelsToUse)
+    {
+        for (int i = 0; i < this->numChannels; ++i){
+            this->levels[(size_t) i].store (0.0f, std::memory_order_relaxed);
+            this->peaks[(size_t) i].store (0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    int getNumChannels() const noexcept { return this->numChannels; }
+
+    /** Audio thread: sets the linear level of a channel and raises its peak if needed. */
+    void setLevel (int channel, float gain) noexcept{
+        jassert (isPositiveAndBelow (channel, this->numChannels));
+        this->levels[(size_t) channel].store (gain, std::memory_order_relaxed);
+
+        std::atomic<float>& peak = this->peaks[(size_t) channel];
+        float previous = peak.load (std::memory_order_relaxed);
+        while (gain > previous && ! peak.compare_exchange_weak (previous, gain, std::memory_order_relaxed)) {}
+    }
+
+    /** Audio thread: measures the magnitude of a block and stores it as the channel level. */
+    void pushBlock (int channel, const float* samples, int numSamples) noexcept{
+        const Range<float> r (FloatVectorOperations::findMinAndMax (samples, numSamples));
+        setLevel (channel, jmax (std::abs (r.getStart()), std::abs (r.getEnd())));
+    }
+
+    float getLevel (int channel) const noexcept  { return this->levels[(size_t) channel].load (std::memory_order_relaxed); }
+    float getPeak (int channel) const noexcept   { return this->peaks[(size_t) channel].load (std::memory_order_relaxed); }
+
+    /** Message thread: forgets the peak hold of a channel, e.g. when its meter is clicked. */
+    void resetPeak (int channel) noexcept        { this->peaks[(size_t) channel].store (0.0f, std::memory_order_relaxed); }
+
+private:
+    const int numChannels;
+    std::vector<std::atomic<float>> levels, peaks;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisMeterLevels)
+};
+
+//==============================================================================
+/** Draws the meters of every channel of a GrisMeterLevels in one paint pass.
+
+ The bank polls the levels at a fixed rate, works out which bars moved by at least
+ one pixel and only invalidates those; paint() then skips every bar outside the
+ clip region. Bars are filled with the look and feel's green, red and off colours.
+ */
+class GrisLevelMeterBank : public Component, private Timer {
+public:
+    GrisLevelMeterBank (GrisLookAndFeel& lookAndFeel, GrisMeterLevels& levelsToShow, int numRowsToUse = 1)
+        : lnf (lookAndFeel), levels (levelsToShow),
+          numRows (jmax (1, numRowsToUse)),
+          minimumDecibels (-60.0f), redDecibels (-3.0f), gap (1),
+          drawnLevel ((size_t) levelsToShow.getNumChannels(), -1),
+          drawnPeak ((size_t) levelsToShow.getNumChannels(), -1)
+    {
+        setOpaque (true);
+        startTimerHz (30);
+    }
+
+    void setRefreshRate (int framesPerSecond)       { startTimerHz (jmax (1, framesPerSecond)); }
+    void setDecibelRange (float minimumDb, float redAboveDb){
+        this->minimumDecibels = minimumDb;
+        this->redDecibels = redAboveDb;
+        invalidateAll();
+    }
+
+    /** Compares the current levels with what was last drawn and returns the bars to repaint. */
+    RectangleList<int> collectChangedBars(){
+        RectangleList<int> changed;
+
+        for (int i = 0; i < this->levels.getNumChannels(); ++i){
+            const Rectangle<int> bar (getBarBounds (i));
+            const int level = levelToPixels (this->levels.getLevel (i), bar.getHeight());
+            const int peak  = levelToPixels (this->levels.getPeak (i), bar.getHeight());
+
+            if (level != this->drawnLevel[(size_t) i] || peak != this->drawnPeak[(size_t) i]){
+                this->drawnLevel[(size_t) i] = level;
+                this->drawnPeak[(size_t) i] = peak;
+                changed.addWithoutMerging (bar);
+            }
+        }
+
+        return changed;
+    }
+
+    void paint (Graphics& g) override{
+        const GrisTheme& t = this->lnf.getTheme();
+        g.fillAll (t.winBackground);
+
+        for (int i = 0; i < this->levels.getNumChannels(); ++i){
+            const Rectangle<int> bar (getBarBounds (i));
+
+            if (! g.clipRegionIntersects (bar))
+                continue;
+
+            const int level = jmax (0, this->drawnLevel[(size_t) i]);
+            const int peak = jmax (0, this->drawnPeak[(size_t) i]);
+            const int redStart = levelToPixels (Decibels::decibelsToGain (this->redDecibels), bar.getHeight());
+
+            Rectangle<int> r (bar);
+            g.setColour (t.off);
+            g.fillRect (r.removeFromTop (bar.getHeight() - level));
+
+            g.setColour (t.red);
+            g.fillRect (r.removeFromTop (jmax (0, level - redStart)));
+
+            g.setColour (t.green);
+            g.fillRect (r);
+
+            if (peak > 0){
+                g.setColour (peak > redStart ? t.red : t.light);
+                g.fillRect (bar.getX(), bar.getBottom() - peak, bar.getWidth(), 1);
+            }
+        }
+    }
+
+    void resized() override{
+        invalidateAll();
+    }
+
+    void mouseDown (const MouseEvent& e) override{
+        for (int i = 0; i < this->levels.getNumChannels(); ++i){
+            if (getBarBounds (i).contains (e.getPosition())){
+                this->levels.resetPeak (i);
+                break;
+            }
+        }
+    }
+
+    Rectangle<int> getBarBounds (int channel) const{
+        const int numChannels = jmax (1, this->levels.getNumChannels());
+        const int numColumns = (numChannels + this->numRows - 1) / this->numRows;
+        const int column = channel % numColumns;
+        const int row = channel / numColumns;
+        const int rowHeight = getHeight() / this->numRows;
+
+        const int x0 = (column * getWidth()) / numColumns;
+        const int x1 = ((column + 1) * getWidth()) / numColumns;
+        return Rectangle<int> (x0, row * rowHeight, x1 - x0 - this->gap, rowHeight - this->gap);
+    }
+
+private:
+    int levelToPixels (float gain, int height) const{
+        const float db = Decibels::gainToDecibels (gain, this->minimumDecibels);
+        const float proportion = (db - this->minimumDecibels) / (0.0f - this->minimumDecibels);
+        return jlimit (0, height, roundToInt (proportion * height));
+    }
+
+    void invalidateAll(){
+        std::fill (this->drawnLevel.begin(), this->drawnLevel.end(), -1);
+        std::fill (this->drawnPeak.begin(), this->drawnPeak.end(), -1);
+        collectChangedBars();
+        repaint();
+    }
+
+    void timerCallback() override{
+        const RectangleList<int> changed (collectChangedBars());
+
+        for (const Rectangle<int>* r = changed.begin(); r != changed.end(); ++r)
+            repaint (*r);
+    }
+
+    GrisLookAndFeel& lnf;
+    GrisMeterLevels& levels;
+    int numRows;
+    float minimumDecibels, redDecibels;
+    int gap;
+    std::vector<int> drawnLevel, drawnPeak;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisLevelMeterBank)
+};
+
+#endif
@@ -26,6 +26,13 @@
 #define GRISLOOKANDFEEL_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisAllocationCounter.h"
+#include "GrisFonts.h"
+#include "GrisGlyphAtlas.h"
+#include "GrisPaintInstrumentation.h"
+#include "GrisSpriteCache.h"
+#include "GrisTextLayoutCache.h"
+#include "GrisTheme.h"
 
 //==============================================================================
 /** Custom Look And Feel subclasss.
@@ -41,296 +48,702 @@
 class GrisLookAndFeel    : public LookAndFeel_V3 {
 private:
     
+    const int64 constructionStartTicks = Time::getHighResolutionTicks();
+
     float fontSize;
 
-    Font  font = Font(juce::CustomTypeface::createSystemTypefaceFor(BinaryData::SinkinSans400Regular_otf, (size_t) BinaryData::SinkinSans400Regular_otfSize));
+    SharedResourcePointer<GrisSharedTypeface> sharedTypeface;
+    SharedResourcePointer<GrisGlyphAtlasCache> glyphAtlases;
+    Font  font = Font(this->sharedTypeface->getTypeface()).withHeight(GrisFontMetrics::getBaseHeight());
+    GrisScaledFonts scaledFonts { this->font };
+    float scaleFactor = 1.0f;
+
+    GrisTheme::Ptr theme;
+    Array<Component::SafePointer<Component>> themedEditors;
 
-    Colour backGroundAndFieldColour, winBackGroundAndFieldColour;
-    Colour lightColour, darkColour, greyColour, editBgcolor;
-    Colour onColor, onColorOver, onColorDown, offColor, greenColor, redColor;
+    bool rotaryFilmstripEnabled;
+    int  rotaryFilmstripFrames;
+    GrisSpriteCache rotaryFilmstripCache;
+    bool roundThumbCacheEnabled;
+    GrisSpriteCache roundThumbCache;
+    GrisSpriteCache comboBoxArrowCache;
+    bool renderMemoEnabled;
+    GrisSpriteCache renderMemoCache { 4 * 1024 * 1024 };
+    GrisTextLayoutCache textLayoutCache;
+    GrisGlyphAtlas::Ptr textAtlas;
+    float textAtlasScale = 0.0f;
+    SpinLock textAtlasLock;
+
+    Path  comboBoxArrows;
     
-public:
-    GrisLookAndFeel(){
-        
-        this->backGroundAndFieldColour      = Colour::fromRGB(75, 75, 75);  //Colours::darkgrey;
-        this->winBackGroundAndFieldColour   = Colour::fromRGB(46, 46, 46);
-        
-        this->lightColour               = Colour::fromRGB(235, 245, 250);   //Colours::whitesmoke;
-        this->darkColour                = Colour::fromRGB(15,  10,  5);       //Colours::black;
-        this->greyColour                = Colour::fromRGB(120, 120, 120);   //Colours::grey;
-        this->editBgcolor               = Colour::fromRGB(172, 172, 172);
-        
-        this->onColor                   = Colour::fromRGB(255, 165, 25);
-        this->onColorOver               = Colour::fromRGB(255, 184, 75);
-        this->onColorDown               = Colour::fromRGB(222, 144, 22);
-        this->offColor                  = Colour::fromRGB(56,  56,  56);
-       
-        this->greenColor                = Colour::fromRGB(56,  156,  56);
-        this->redColor                  = Colour::fromRGB(220,  48,  35);
-        
-        setColour(PopupMenu::highlightedBackgroundColourId, this->onColor);
-        setColour(TextEditor::backgroundColourId, this->editBgcolor);
-        setColour(TextEditor::highlightColourId, this->onColor);
-        setColour(TextEditor::shadowColourId, this->editBgcolor);
+    enum SpriteKind { rotaryFilmstripSprite = 1, roundThumbSprite, comboBoxArrowSprite, toggleButtonRender, tabButtonRender };
+
+    // room for the outline and the shadow around a round thumb
+    enum { roundThumbMargin = 2 };
+
+    void applyThemeColourIds(){
+        const GrisTheme& t = *this->theme;
+
+        setColour(PopupMenu::highlightedBackgroundColourId, t.on);
+        setColour(TextEditor::backgroundColourId, t.editBackground);
+        setColour(TextEditor::highlightColourId, t.on);
+        setColour(TextEditor::shadowColourId, t.editBackground);
         
-        setColour(TextButton::buttonColourId, this->editBgcolor);
+        setColour(TextButton::buttonColourId, t.editBackground);
         
-        setColour(ComboBox::backgroundColourId, this->editBgcolor);
-        setColour(ComboBox::outlineColourId, this->editBgcolor);
+        setColour(ComboBox::backgroundColourId, t.editBackground);
+        setColour(ComboBox::outlineColourId, t.editBackground);
         
-        setColour(Slider::thumbColourId, this->lightColour);
-        setColour(Slider::rotarySliderFillColourId, this->onColor);
-        setColour(Slider::trackColourId, this->darkColour);
-        setColour(Slider::textBoxBackgroundColourId, this->editBgcolor);
+        setColour(Slider::thumbColourId, t.light);
+        setColour(Slider::rotarySliderFillColourId, t.on);
+        setColour(Slider::trackColourId, t.dark);
+        setColour(Slider::textBoxBackgroundColourId, t.editBackground);
         setColour(Slider::textBoxOutlineColourId, Colours::transparentBlack);
         
-        setColour(TooltipWindow::ColourIds::backgroundColourId,this->backGroundAndFieldColour.withBrightness(0.8));
-        setColour(TooltipWindow::ColourIds::outlineColourId, this->backGroundAndFieldColour.withBrightness(0.8));
+        setColour(TooltipWindow::ColourIds::backgroundColourId, t.background.withBrightness(0.8));
+        setColour(TooltipWindow::ColourIds::outlineColourId, t.background.withBrightness(0.8));
+        
+        setColour(AlertWindow::backgroundColourId, t.winBackground);
+        setColour(AlertWindow::outlineColourId, t.on);
+        setColour(AlertWindow::textColourId, t.light);
+    }
+
+    void paletteChanged(){
+        this->rotaryFilmstripCache.clear();
+        this->roundThumbCache.clear();
+        this->comboBoxArrowCache.clear();
+        this->renderMemoCache.clear();
+    }
+
+    /** Draws a whole widget of w x h from the render memo, painting it into a new
+        sprite with paintShape when its signature is not there yet. The signature must
+        hold every input that changes the pixels; the scale is added here.
+     */
+    template <typename PaintFunction>
+    void drawMemoised (Graphics& g, GrisSpriteKey signature, int w, int h, PaintFunction paintShape){
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const uint64 key = signature.add (scale).get();
+        Image sprite (this->renderMemoCache.get (key));
+
+        if (! sprite.isValid()){
+            sprite = Image (Image::ARGB, jmax (1, (int) std::ceil (w * scale)), jmax (1, (int) std::ceil (h * scale)), true);
+            Graphics sg (sprite);
+            sg.addTransform (AffineTransform::scale (scale));
+            paintShape (sg);
+            this->renderMemoCache.put (key, sprite);
+        }
+
+        if (scale == 1.0f)
+            g.drawImageAt (sprite, 0, 0);
+        else
+            g.drawImageTransformed (sprite, AffineTransform::scale (1.0f / scale));
+    }
+
+    /** The atlas of getScaledFont(scale), kept for the last scale so that painting text
+        does not look it up again, or nullptr while prepareGlyphAtlas() is still making it.
+     */
+    GrisGlyphAtlas::Ptr getTextAtlas (float scale){
+        {
+            const SpinLock::ScopedLockType sl (this->textAtlasLock);
+
+            if (this->textAtlas != nullptr && this->textAtlasScale == scale)
+                return this->textAtlas;
+        }
+
+        GrisGlyphAtlas::Ptr atlas (this->glyphAtlases->find (this->sharedTypeface->getDataHash(), getScaledFont (scale).getHeight(), scale));
+
+        if (atlas == nullptr){
+            prepareGlyphAtlas (scale);
+            return nullptr;
+        }
+
+        const SpinLock::ScopedLockType sl (this->textAtlasLock);
+        this->textAtlas = atlas;
+        this->textAtlasScale = scale;
+        return atlas;
+    }
+
+    /** Blits a line of text of getScaledFont() from the glyph atlas, where drawFittedText
+        would place it, and returns true. Returns false without drawing when the text needs
+        the layout instead: characters missing from the atlas, spaces to trim, a text wider
+        than the area, or an atlas not made yet for this scale.
+     */
+    bool drawAtlasText (Graphics& g, const String& text, const Rectangle<int>& area, Justification justification){
+        if (text.isEmpty() || CharacterFunctions::isWhitespace (text[0])
+             || CharacterFunctions::isWhitespace (text.getLastCharacter()))
+            return false;
+
+        const GrisGlyphAtlas::Ptr atlas (getTextAtlas (g.getInternalContext().getPhysicalPixelScaleFactor()));
+
+        if (atlas == nullptr)
+            return false;
+
+        const char* utf8 = text.toRawUTF8();
+
+        if (! atlas->canDraw (utf8))
+            return false;
+
+        const float width = atlas->getStringWidth (utf8);
+
+        if (width > (float) area.getWidth())
+            return false;
+
+        float x = (float) area.getX();
+        float top = (float) area.getY();
+
+        if (justification.testFlags (Justification::horizontallyCentred))
+            x += (area.getWidth() - width) * 0.5f;
+        else if (justification.testFlags (Justification::right))
+            x = area.getRight() - width;
+
+        if (justification.testFlags (Justification::verticallyCentred))
+            top += (area.getHeight() - atlas->getHeight()) * 0.5f;
+        else if (justification.testFlags (Justification::bottom))
+            top = area.getBottom() - atlas->getHeight();
+
+        atlas->drawText (g, utf8, x, top + atlas->getAscent());
+        return true;
+    }
+
+public:
+    GrisLookAndFeel(){
         
-        setColour(AlertWindow::backgroundColourId, this->winBackGroundAndFieldColour);
-        setColour(AlertWindow::outlineColourId, this->onColor);
-        setColour(AlertWindow::textColourId, this->lightColour);
+        this->theme = GrisTheme::getBuiltIn();
+        applyThemeColourIds();
         
-#if WIN32
-        this->fontSize = 18.f;
-#else
-        this->fontSize = 10.f;
-#endif
-        this->font.setHeight(this->fontSize);
-       
+        this->fontSize = GrisFontMetrics::getBaseHeight();
+
+        this->rotaryFilmstripEnabled = false;
+        this->rotaryFilmstripFrames  = 128;
+        this->roundThumbCacheEnabled = true;
+        this->renderMemoEnabled = false;
+
+        // combo box arrows in a unit square, scaled to the button on each paint
+        const float arrowX = 0.3f;
+        const float arrowH = 0.2f;
+        this->comboBoxArrows.addTriangle (0.5f, 0.45f - arrowH, 1.0f - arrowX, 0.45f, arrowX, 0.45f);
+        this->comboBoxArrows.addTriangle (0.5f, 0.55f + arrowH, 1.0f - arrowX, 0.55f, arrowX, 0.55f);
+
+        prepareGlyphAtlas (this->scaleFactor);
+
+        ConstructionStats& stats = getConstructionStats();
+        ++stats.numInstances;
+        ++stats.numConstructed;
+        stats.lastConstructionSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - this->constructionStartTicks);
+    }
+
+    ~GrisLookAndFeel(){
+        --getConstructionStats().numInstances;
+    }
+
+    /** Figures used to compare the cost of one look and feel per plugin instance with a shared one.
+
+     Per-instance memory is sizeof (GrisLookAndFeel) plus the parsed typeface, which is only
+     paid again when typefaceLoads grows along with numConstructed.
+     */
+    struct ConstructionStats {
+        int numInstances = 0;
+        int numConstructed = 0;
+        double lastConstructionSeconds = 0.0;
+    };
+
+    static ConstructionStats& getConstructionStats(){
+        static ConstructionStats stats;
+        return stats;
+    }
+    static int getNumTypefaceLoads(){
+        return GrisSharedTypeface::getNumLoads();
+    }
+    static size_t getInstanceSizeInBytes(){
+        return sizeof (GrisLookAndFeel);
     }
     
     Font getFont(){
-        return this->font;
+        return this->scaledFonts.getFont(this->scaleFactor);
+    }
+
+    /** Physical pixels per logical pixel of a component: its transforms, such as the one
+        AudioProcessorEditor::setScaleFactor() sets, times the scale of the display it is on.
+        Falls back to getScaleFactor() while the component is not showing.
+     */
+    float getComponentScale(Component& component) const{
+        if (! component.isShowing())
+            return this->scaleFactor;
+
+        float scale = Component::getApproximateScaleFactorForComponent(&component);
+
+        if (const Displays::Display* display = Desktop::getInstance().getDisplays().getDisplayForPoint(component.getScreenBounds().getCentre()))
+            scale *= (float) display->scale;
+
+        return scale;
     }
+
     Font getLabelFont (Label & label) override{
-        return this->font;
+        return getScaledFont(getComponentScale(label));
+    }
+
+    /** LookAndFeel_V2::drawLabel, with the text blitted from the glyph atlas when it is a
+        single line of the look and feel font at the scale painted.
+     */
+    void drawLabel (Graphics& g, Label& label) override{
+        GRIS_PAINT_ALLOCATION_CHECK ("drawLabel", false);
+        GRIS_PAINT_PROBE ("drawLabel", g, &label);
+
+        g.fillAll (label.findColour (Label::backgroundColourId));
+
+        if (! label.isBeingEdited()){
+            const float alpha = label.isEnabled() ? 1.0f : 0.5f;
+            const Font font (getLabelFont (label));
+            const Rectangle<int> textArea (label.getBorderSize().subtractedFrom (label.getLocalBounds()));
+
+            g.setColour (label.findColour (Label::textColourId).withMultipliedAlpha (alpha));
+
+            if (font != getScaledFont (g.getInternalContext().getPhysicalPixelScaleFactor())
+                 || ! drawAtlasText (g, label.getText(), textArea, label.getJustificationType())){
+                const float minimumHorizontalScale = label.getMinimumHorizontalScale();
+
+                this->textLayoutCache.drawFittedText (g, font, label.getText(), textArea.getX(), textArea.getY(),
+                                                      textArea.getWidth(), textArea.getHeight(), label.getJustificationType(),
+                                                      jmax (1, (int) (textArea.getHeight() / font.getHeight())),
+                                                      minimumHorizontalScale > 0.0f ? minimumHorizontalScale
+                                                                                    : Font::getDefaultMinimumHorizontalScaleFactor());
+            }
+
+            g.setColour (label.findColour (Label::outlineColourId).withMultipliedAlpha (alpha));
+        }else if (label.isEnabled()){
+            g.setColour (label.findColour (Label::outlineColourId));
+        }
+
+        g.drawRect (label.getLocalBounds());
     }
     Font getComboBoxFont (ComboBox & comboBox) override{
-        return this->font;
+        return getScaledFont(getComponentScale(comboBox));
+    }
+    Font getTextButtonFont (TextButton & button, int buttonHeight) override{
+        return getScaledFont(getComponentScale(button));
+    }
+    Font getMenuBarFont	(MenuBarComponent & menuBar, int itemIndex, const String & itemText) override{
+        return getScaledFont(getComponentScale(menuBar));
     }
-    Font getTextButtonFont (TextButton &, int buttonHeight) override{
-        return this->font;
+
+    /** Display scale used by getFont(), and for components that are not showing yet.
+
+     Fonts asked for a component take the scale of that component, so editors sharing one
+     GrisSharedLookAndFeel at different zoom levels each get their own. This one is
+     process-wide for a shared instance: calling it from AudioProcessorEditor::setScaleFactor()
+     only warms the fonts and the glyph atlas of that scale up ahead of time. The fonts for a
+     scale are built, and their glyphs warmed up off the message thread, the first time it is used.
+     */
+    void setScaleFactor(float newScale){
+        this->scaleFactor = newScale;
+        this->scaledFonts.getFont(newScale);
+        prepareGlyphAtlas(newScale);
     }
-    Font getMenuBarFont	(MenuBarComponent &, int itemIndex, const String & itemText) override{
-        return this->font;
+    float getScaleFactor() const{
+        return this->scaleFactor;
+    }
+
+    /** The look and feel font for a physical pixel scale, for components that draw their own text. */
+    const Font& getScaledFont(float scale){
+        return this->scaledFonts.getFont(scale);
+    }
+
+    /** Pre-rasterised glyphs of getScaledFont(scale), mapped from the on-disk cache when it is valid.
+        Maps or builds the atlas on the calling thread if it is not in memory yet.
+     */
+    GrisGlyphAtlas::Ptr getGlyphAtlas(float scale){
+        return this->glyphAtlases->get(getScaledFont(scale), this->sharedTypeface->getDataHash(), scale);
+    }
+
+    /** The same for the look and feel typeface at another height, snapped for the scale. */
+    GrisGlyphAtlas::Ptr getGlyphAtlas(float scale, float height){
+        return this->glyphAtlases->get(this->font.withHeight(GrisFontMetrics::snapHeight(height, scale)),
+                                       this->sharedTypeface->getDataHash(), scale);
+    }
+
+    /** Makes the atlas of getScaledFont(scale) on the shared GrisWorkerPool. Labels and buttons
+        painted at that scale blit their text from it once it is ready, and lay it out until then.
+     */
+    void prepareGlyphAtlas(float scale){
+        this->glyphAtlases->prepare(getScaledFont(scale), this->sharedTypeface->getDataHash(), scale);
     }
     
     Colour getWinBackgroundColour(){
-        return this->winBackGroundAndFieldColour;
+        return this->theme->winBackground;
     }
 
     Colour getBackgroundColour(){
-        return this->backGroundAndFieldColour;
+        return this->theme->background;
     }
     
     Colour getFieldColour(){
-        return this->backGroundAndFieldColour;
+        return this->theme->background;
     }
     
     Colour getFontColour(){
-        return this->lightColour;
+        return this->theme->light;
     }
     
     Colour getScrollBarColour(){
-        return this->greyColour;
+        return this->theme->grey;
     }
     
     Colour getDarkColour(){
-        return this->darkColour;
+        return this->theme->dark;
     }
     
     Colour getLightColour(){
-        return this->lightColour;
+        return this->theme->light;
     }
     
     Colour getOnColour(){
-        return this->onColor;
+        return this->theme->on;
     }
     Colour getOffColour(){
-        return this->offColor;
+        return this->theme->off;
     }
     Colour getGreenColour(){
-        return this->greenColor;
+        return this->theme->green;
     }
     Colour getRedColour(){
-        return this->redColor;
+        return this->theme->red;
+    }
+
+    const GrisTheme& getTheme() const{
+        return *this->theme;
+    }
+    GrisTheme::Ptr getThemePtr() const{
+        return this->theme;
+    }
+
+    /** Switches every widget drawn by this look and feel to another theme.
+
+     The derived colours were resolved when newTheme was built, so this only swaps the
+     pointer, refreshes the JUCE colour ids and repaints the registered editors once.
+     */
+    void setTheme(GrisTheme::Ptr newTheme){
+        jassert (newTheme != nullptr);
+        if (newTheme == nullptr || newTheme == this->theme)
+            return;
+
+        this->theme = newTheme;
+        applyThemeColourIds();
+        paletteChanged();
+
+        for (int i = this->themedEditors.size(); --i >= 0;){
+            if (Component* editor = this->themedEditors.getReference (i))
+                editor->repaint();
+            else
+                this->themedEditors.remove (i);
+        }
+    }
+
+    /** Editors registered here are repainted when the theme changes. */
+    void registerThemedEditor(Component* editor){
+        this->themedEditors.addIfNotAlreadyThere (editor);
+    }
+    void unregisterThemedEditor(Component* editor){
+        this->themedEditors.removeAllInstancesOf (editor);
+    }
+
+    void setOnColours(Colour on, Colour over, Colour down){
+        GrisTheme::Palette p = this->theme->palette;
+        p.on     = on.getARGB();
+        p.onOver = over.getARGB();
+        p.onDown = down.getARGB();
+        setTheme (new GrisTheme (p));
+    }
+    void setOffColour(Colour off){
+        GrisTheme::Palette p = this->theme->palette;
+        p.off = off.getARGB();
+        setTheme (new GrisTheme (p));
+    }
+
+    /** Makes drawRotarySlider blit pre-rendered knob frames instead of building paths.
+
+     Frames are rendered lazily, one per angle step, and kept per size, scale factor
+     and state (enabled, hover, off) until maxCacheBytes is reached.
+     */
+    void setRotaryFilmstripEnabled(bool shouldCache, int angleSteps = 128, size_t maxCacheBytes = 8 * 1024 * 1024){
+        jassert (angleSteps > 1);
+        this->rotaryFilmstripEnabled = shouldCache;
+        this->rotaryFilmstripFrames  = jmax (2, angleSteps);
+        this->rotaryFilmstripCache.setMaxBytes (maxCacheBytes);
+        this->rotaryFilmstripCache.clear();
+    }
+    bool isRotaryFilmstripEnabled() const{
+        return this->rotaryFilmstripEnabled;
+    }
+    const GrisSpriteCache& getRotaryFilmstripCache() const{
+        return this->rotaryFilmstripCache;
+    }
+
+    /** When enabled (the default), drawRoundThumb composites one cached sprite holding the
+        shadow, fill and outline instead of blurring a new shadow on every call.
+     */
+    void setRoundThumbCacheEnabled(bool shouldCache){
+        this->roundThumbCacheEnabled = shouldCache;
+    }
+    bool isRoundThumbCacheEnabled() const{
+        return this->roundThumbCacheEnabled;
+    }
+    GrisSpriteCache& getRoundThumbCache(){
+        return this->roundThumbCache;
+    }
+
+    /** Makes drawToggleButton and drawTabButton blit the image of their last paint with
+        the same inputs, e.g. when a sibling invalidated an idle widget.
+
+     Each paint is keyed by a signature of everything it depends on: size, scale,
+     text, colours and the enabled, hover, down and toggle states. Images are kept
+     until maxCacheBytes is reached, the least recently drawn going first, and the
+     hits and misses of getRenderMemoCache() tell how often the memo is used.
+     */
+    void setRenderMemoisationEnabled(bool shouldMemoise, size_t maxCacheBytes = 4 * 1024 * 1024){
+        this->renderMemoEnabled = shouldMemoise;
+        this->renderMemoCache.setMaxBytes (maxCacheBytes);
+
+        if (! shouldMemoise)
+            this->renderMemoCache.clear();
+    }
+    bool isRenderMemoisationEnabled() const{
+        return this->renderMemoEnabled;
+    }
+    GrisSpriteCache& getRenderMemoCache(){
+        return this->renderMemoCache;
+    }
+
+    /** The layouts of the strings this look and feel draws without the glyph atlas. */
+    GrisTextLayoutCache& getTextLayoutCache(){
+        return this->textLayoutCache;
     }
     
     //https://github.com/audioplastic/Juce-look-and-feel-examples/blob/master/JuceLibraryCode/modules/juce_gui_basics/lookandfeel/juce_LookAndFeel.cpp
     
     void drawComboBox(Graphics& g,int width, int height,bool isButtonDown,int buttonX,int buttonY,int buttonW,int buttonH,ComboBox & box) override
     {
-        box.setColour(ColourSelector::backgroundColourId, this->onColor);
-    
-        g.fillAll (this->editBgcolor);//box.findColour (ComboBox::backgroundColourId))
-        
-        const Colour buttonColour (this->darkColour);//box.findColour (ComboBox::buttonColourId)
-        const float arrowX = 0.3f;
-        const float arrowH = 0.2f;
-        
-        Path p;
-        p.addTriangle (buttonX + buttonW * 0.5f,            buttonY + buttonH * (0.45f - arrowH),
-                       buttonX + buttonW * (1.0f - arrowX), buttonY + buttonH * 0.45f,
-                       buttonX + buttonW * arrowX,          buttonY + buttonH * 0.45f);
-        
-        p.addTriangle (buttonX + buttonW * 0.5f,            buttonY + buttonH * (0.55f + arrowH),
-                       buttonX + buttonW * (1.0f - arrowX), buttonY + buttonH * 0.55f,
-                       buttonX + buttonW * arrowX,          buttonY + buttonH * 0.55f);
+        GRIS_PAINT_ALLOCATION_CHECK ("drawComboBox", false);
+        GRIS_PAINT_PROBE ("drawComboBox", g, &box);
+
+        const GrisTheme& t = *this->theme;
+
+        g.fillAll (t.editBackground);//box.findColour (ComboBox::backgroundColourId))
         
-        g.setColour (this->darkColour.withMultipliedAlpha (box.isEnabled() ? 1.0f : 0.3f));//box.findColour (ComboBox::arrowColourId)
-        g.fillPath (p);
+        if (buttonW <= 0 || buttonH <= 0)
+            return;
+
+        //box.findColour (ComboBox::arrowColourId)
+        const Image arrows (getComboBoxArrowSprite (t, buttonW, buttonH, box.isEnabled(), g.getInternalContext().getPhysicalPixelScaleFactor()));
+        g.drawImage (arrows, buttonX, buttonY, buttonW, buttonH, 0, 0, arrows.getWidth(), arrows.getHeight());
+    }
+
+    /** The combo box arrows for a button of this size, rendered on first use. Thread safe. */
+    Image getComboBoxArrowSprite (const GrisTheme& t, int buttonW, int buttonH, bool isEnabled, float scale)
+    {
+        const Colour colour (t.getColour (GrisTheme::comboBoxArrow, isEnabled ? GrisTheme::normal : GrisTheme::disabled));
+        const uint64 key = GrisSpriteKey (comboBoxArrowSprite).add (buttonW).add (buttonH).add (colour).add (scale).get();
+        Image sprite (this->comboBoxArrowCache.get (key));
+
+        if (! sprite.isValid()){
+            const int w = jmax (1, roundToInt (buttonW * scale));
+            const int h = jmax (1, roundToInt (buttonH * scale));
+            sprite = Image (Image::ARGB, w, h, true);
+            Graphics sg (sprite);
+            sg.setColour (colour);
+            sg.fillPath (this->comboBoxArrows, AffineTransform::scale ((float) w, (float) h));
+            this->comboBoxArrowCache.put (key, sprite);
+        }
+
+        return sprite;
     }
     
     void drawRoundThumb (Graphics& g, const float x, const float y, const float diameter, const Colour& colour, float outlineThickness) {
-        const juce::Rectangle<float> a (x, y, diameter, diameter);
+        GRIS_PAINT_ALLOCATION_CHECK ("drawRoundThumb", false);
+        GRIS_PAINT_PROBE ("drawRoundThumb", g, nullptr);
+
+        if (! this->roundThumbCacheEnabled || diameter <= 0.0f){
+            drawRoundThumbShape (g, x, y, diameter, colour, outlineThickness);
+            return;
+        }
+
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const Image sprite (getRoundThumbSprite (*this->theme, diameter, colour, outlineThickness, scale));
+        g.drawImageTransformed (sprite, AffineTransform::scale (1.0f / scale).translated (x - roundThumbMargin, y - roundThumbMargin));
+    }
+
+    /** The shadowed thumb drawn by drawRoundThumb, rendered on first use. Thread safe. */
+    Image getRoundThumbSprite (const GrisTheme& t, float diameter, const Colour& colour, float outlineThickness, float scale) {
+        const uint64 key = GrisSpriteKey (roundThumbSprite).add (diameter).add (outlineThickness).add (colour)
+                                                            .add (t.dark).add (scale).get();
+        Image sprite (this->roundThumbCache.get (key));
+
+        if (! sprite.isValid()){
+            const int size = jmax (1, (int) std::ceil ((diameter + roundThumbMargin * 2.0f) * scale));
+            sprite = Image (Image::ARGB, size, size, true);
+            Graphics sg (sprite);
+            sg.addTransform (AffineTransform::scale (scale));
+            drawRoundThumbShape (sg, t, (float) roundThumbMargin, (float) roundThumbMargin, diameter, colour, outlineThickness);
+            this->roundThumbCache.put (key, sprite);
+        }
+
+        return sprite;
+    }
+
+    /** Transparent border, in logical pixels, around the thumb in a round thumb sprite. */
+    static int getRoundThumbSpriteMargin() noexcept{
+        return roundThumbMargin;
+    }
+
+    void drawRoundThumbShape (Graphics& g, const float x, const float y, const float diameter, const Colour& colour, float outlineThickness) {
+        drawRoundThumbShape (g, *this->theme, x, y, diameter, colour, outlineThickness);
+    }
+
+    void drawRoundThumbShape (Graphics& g, const GrisTheme& t, const float x, const float y, const float diameter, const Colour& colour, float outlineThickness) {
         const float halfThickness = outlineThickness * 0.5f;
         
         Path p;
         p.addEllipse (x + halfThickness, y + halfThickness, diameter - outlineThickness, diameter - outlineThickness);
         
-        const DropShadow ds (this->darkColour, 1, Point<int> (0, 0));
+        const DropShadow ds (t.dark, 1, Point<int> (0, 0));
         ds.drawForPath (g, p);
         
         g.setColour (colour);
         g.fillPath (p);
         
-        g.setColour (colour.brighter());
+        g.setColour (t.getBrighter (colour));
         g.strokePath (p, PathStrokeType (outlineThickness));
     }
     
     void drawButtonBackground (Graphics& g, Button& button, const Colour& backgroundColour, bool isMouseOverButton, bool isButtonDown) override {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawButtonBackground", true);
+        GRIS_PAINT_PROBE ("drawButtonBackground", g, &button);
         
         const float width  = button.getWidth() - 1.0f;
         const float height = button.getHeight() - 1.0f;
         const float cornerSize = jmin (15.0f, jmin (width, height) * 0.45f);
         const float lineThickness = cornerSize * 0.1f;
         const float halfThickness = lineThickness * 0.5f;
-        Path outline;
-        outline.addRectangle(0.5f + halfThickness, 0.5f + halfThickness, width - lineThickness, height - lineThickness);
+        const Rectangle<float> outline (0.5f + halfThickness, 0.5f + halfThickness, width - lineThickness, height - lineThickness);
+        const GrisTheme& t = *this->theme;
         g.setColour (button.findColour(TextButton::buttonColourId));
         if (isButtonDown || isMouseOverButton){
-            g.setColour (this->onColorOver);
+            g.setColour (t.getColour (GrisTheme::buttonBackground, GrisTheme::hover));
         }
         if ( button.getToggleState()) {
-            g.setColour (this->onColor);//outlineColour
+            g.setColour (t.getColour (GrisTheme::buttonBackground, GrisTheme::toggled));//outlineColour
         }
         if(button.isEnabled() && button.isMouseButtonDown()){
-            g.setColour (this->onColorDown);
+            g.setColour (t.getColour (GrisTheme::buttonBackground, GrisTheme::down));
         }
-        g.fillPath (outline);
+        g.fillRect (outline);
     }
     
     
     void drawTickBox (Graphics& g, Component& component, float x, float y, float w, float h, bool ticked, bool isEnabled, bool isMouseOverButton, bool isButtonDown) override {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawTickBox", true);
+        GRIS_PAINT_PROBE ("drawTickBox", g, &component);
+
         const float boxSize = w * 0.8f;
         const Rectangle<float> r (x, y + (h - boxSize) * 0.5f, boxSize, boxSize);
 
-        if (ticked) {
-            Colour colour = this->onColor;
-            
-            if(component.isMouseOver()){
-                colour = this->onColorOver;
-            }
-            
-            if(!component.isEnabled()){
-                colour = this->onColor.withBrightness(0.3f);
-            }
-            g.setColour (colour);
-            g.fillRect (r);
-
-        }else{
-            Colour colour = this->offColor;
-            if(!component.isEnabled()){
-                colour = this->offColor.withBrightness(0.3f);
-            }
-            g.setColour (colour);
-            g.fillRect (r);
-        }
-        
-        if(component.isEnabled() && component.isMouseButtonDown()){
-            g.setColour (this->onColorDown);
-            g.fillRect (r);
-        }
+        const GrisTheme::State state = GrisTheme::getState (component.isEnabled(), ticked, component.isMouseOver(),
+                                                            component.isEnabled() && component.isMouseButtonDown());
+        g.setColour (this->theme->getColour (GrisTheme::tickBox, state));
+        g.fillRect (r);
     }
     
     
+    /** LookAndFeel_V2's radius, for a slider of this size. */
+    static int getLinearSliderThumbRadius (int sliderWidth, int sliderHeight){
+        return jmin (7, sliderHeight / 2, sliderWidth / 2) + 2;
+    }
+
+    int getSliderThumbRadius (Slider& slider) override {
+        return getLinearSliderThumbRadius (slider.getWidth(), slider.getHeight());
+    }
+
+    /** The track drawLinearSliderBackground() fills for a slider area, split at the value
+        proportion into the on and off parts. GrisDeltaSlider uses it too, so that what it
+        repaints matches what is drawn.
+     */
+    static Rectangle<float> getLinearSliderTrackBounds (bool isHorizontal, int x, int y, int width, int height, int thumbRadius){
+        const float trackRadius = thumbRadius - 5.0f;
+
+        if (isHorizontal)
+            return Rectangle<float> (x - trackRadius * 0.5f, y + height * 0.5f - trackRadius * 0.5f, width + trackRadius, trackRadius);
+
+        return Rectangle<float> (x + width * 0.5f - trackRadius * 0.5f, y - trackRadius * 0.5f, trackRadius, height + trackRadius);
+    }
+
+    /** The bar drawLinearSliderThumb() fills at sliderPos; a vertical one reaches down the track. */
+    static Rectangle<float> getLinearSliderThumbBounds (bool isHorizontal, int x, int y, int width, int height, float sliderPos, int thumbRadius){
+        const float radius = (float) (thumbRadius - 2);
+        const float kx = isHorizontal ? sliderPos : x + width * 0.5f;
+        const float ky = isHorizontal ? y + height * 0.5f : sliderPos;
+
+        return Rectangle<float> (kx - radius * 0.5f, ky - radius, 6.0f, height * 2.0f);
+    }
+
     void drawLinearSliderThumb (Graphics& g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, const Slider::SliderStyle style, Slider& slider) override {
-        const float sliderRadius = (float) (getSliderThumbRadius (slider) - 2);
-        float kx, ky;
-        
-        if (style == Slider::LinearVertical) {
-            kx = x + width * 0.5f;
-            ky = sliderPos;
-        } else {
-            kx = sliderPos;
-            ky = y + height * 0.5f;
-        }
-        const Rectangle<float> r (kx - (sliderRadius/2.0f), ky- sliderRadius , 6, height*2.0f);
+        GRIS_PAINT_ALLOCATION_CHECK ("drawLinearSliderThumb", true);
+        GRIS_PAINT_PROBE ("drawLinearSliderThumb", g, &slider);
+
+        const Rectangle<float> r (getLinearSliderThumbBounds (style != Slider::LinearVertical, x, y, width, height,
+                                                              sliderPos, getSliderThumbRadius (slider)));
+
+        const GrisTheme::State state = GrisTheme::getState (slider.isEnabled(), false, slider.isMouseOver(), slider.isMouseButtonDown());
+        g.setColour (this->theme->getColour (GrisTheme::linearSliderThumb, state));
+        g.fillRect (r);
 
-        if(slider.isEnabled()){
-            Colour colour = this->onColor;
-            
-            if(slider.isMouseOver()){
-                colour = this->onColorOver;
-            }
-            if(slider.isMouseButtonDown()){
-                colour = this->onColorDown;
-            }
-            g.setColour (colour);
-            g.fillRect (r);
-        }else{
-            g.setColour (this->offColor);
-            g.fillRect (r);
-        }
-        
     }
     
     void drawLinearSlider (Graphics& g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, const Slider::SliderStyle style, Slider& slider) override {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawLinearSlider", true);
+        GRIS_PAINT_PROBE ("drawLinearSlider", g, &slider);
+
         drawLinearSliderBackground (g, x, y, width, height+2, sliderPos, minSliderPos, maxSliderPos, style, slider);
         drawLinearSliderThumb (g, x, y, width, height+2, sliderPos, minSliderPos, maxSliderPos, style, slider);
     }
     
     void drawLinearSliderBackground (Graphics& g, int x, int y, int width, int height, float /*sliderPos*/, float /*minSliderPos*/, float /*maxSliderPos*/, const Slider::SliderStyle /*style*/, Slider& slider) override {
-        const float sliderRadius = getSliderThumbRadius (slider) - 5.0f;
-        Path on, off;
-
-        if (slider.isHorizontal()) {
-            const float iy = y + height * 0.5f - sliderRadius * 0.5f;
-            juce::Rectangle<float> r (x - sliderRadius * 0.5f, iy, width + sliderRadius, sliderRadius);
-            const float onW = r.getWidth() * ((float) slider.valueToProportionOfLength (slider.getValue()));
-            on.addRectangle (r.removeFromLeft (onW));
-            off.addRectangle (r);
-        } else {
-            const float ix = x + width * 0.5f - sliderRadius * 0.5f;
-            juce::Rectangle<float> r (ix, y - sliderRadius * 0.5f, sliderRadius, height + sliderRadius);
-            const float onH = r.getHeight() * ((float) slider.valueToProportionOfLength (slider.getValue()));
-            on.addRectangle (r.removeFromBottom (onH));
-            off.addRectangle (r);
-        }
+        GRIS_PAINT_ALLOCATION_CHECK ("drawLinearSliderBackground", true);
+        GRIS_PAINT_PROBE ("drawLinearSliderBackground", g, &slider);
+
+        juce::Rectangle<float> off (getLinearSliderTrackBounds (slider.isHorizontal(), x, y, width, height, getSliderThumbRadius (slider)));
+        juce::Rectangle<float> on;
+        const float proportion = (float) slider.valueToProportionOfLength (slider.getValue());
+
+        if (slider.isHorizontal())
+            on = off.removeFromLeft (off.getWidth() * proportion);
+        else
+            on = off.removeFromBottom (off.getHeight() * proportion);
         
         if (slider.isEnabled()){
             g.setColour (slider.findColour (Slider::rotarySliderFillColourId));
-            g.fillPath (on);
+            g.fillRect (on);
             g.setColour (slider.findColour (Slider::trackColourId));
-            g.fillPath (off);
+            g.fillRect (off);
         }else{
-            g.setColour (this->offColor);
-            g.fillPath (on);
-            g.fillPath (off);
+            g.setColour (this->theme->off);
+            g.fillRect (on);
+            g.fillRect (off);
         }
        
     }
     
     void fillTextEditorBackground(Graphics& g, int width, int height, TextEditor& t) override {
-        g.setColour(this->editBgcolor);
+        GRIS_PAINT_ALLOCATION_CHECK ("fillTextEditorBackground", true);
+        GRIS_PAINT_PROBE ("fillTextEditorBackground", g, &t);
+        g.setColour(this->theme->editBackground);
         g.fillAll();
     }
     
     void drawTextEditorOutline(Graphics& g, int width, int height, TextEditor& t) override {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawTextEditorOutline", true);
+        GRIS_PAINT_PROBE ("drawTextEditorOutline", g, &t);
         if(t.hasKeyboardFocus(true))
         {
-            g.setColour(this->onColor);
+            g.setColour(this->theme->on);
             g.drawRect (0, 0, width, height);
         }
         
@@ -338,6 +751,25 @@ public:
     }
     
     void drawToggleButton (Graphics& g, ToggleButton& button, bool isMouseOverButton, bool isButtonDown) override {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawToggleButton", false);
+        GRIS_PAINT_PROBE ("drawToggleButton", g, &button);
+
+        if (! this->renderMemoEnabled){
+            drawToggleButtonShape (g, button, isMouseOverButton, isButtonDown);
+            return;
+        }
+
+        // drawTickBox reads the hover and press state from the component, not from the arguments
+        const GrisSpriteKey signature (GrisSpriteKey (toggleButtonRender).add (button.getWidth()).add (button.getHeight())
+                                           .add (button.getButtonText()).add (button.getToggleState()).add (button.isEnabled())
+                                           .add (button.isMouseOver()).add (button.isEnabled() && button.isMouseButtonDown())
+                                           .add (button.findColour (ToggleButton::textColourId)));
+
+        drawMemoised (g, signature, button.getWidth(), button.getHeight(),
+                      [&] (Graphics& sg) { drawToggleButtonShape (sg, button, isMouseOverButton, isButtonDown); });
+    }
+
+    void drawToggleButtonShape (Graphics& g, ToggleButton& button, bool isMouseOverButton, bool isButtonDown) {
         if (button.hasKeyboardFocus (true))
         {
             g.setColour (button.findColour (TextEditor::focusedOutlineColourId));
@@ -348,14 +780,17 @@ public:
             drawTickBox (g, button, 0, 0, button.getWidth(), button.getHeight(),
                          button.getToggleState(), button.isEnabled(),isMouseOverButton,isButtonDown);
             g.setColour(button.findColour (ToggleButton::textColourId));
-            g.setFont(this->font);
+            const Font& font = this->scaledFonts.getFont (g.getInternalContext().getPhysicalPixelScaleFactor());
+            g.setFont(font);
             
             if (! button.isEnabled())
                 g.setOpacity (0.5f);
                 
             
-            g.drawFittedText (button.getButtonText(),-2, 1,button.getWidth() , button.getHeight(),
-                              Justification::centred, 10);
+            if (! drawAtlasText (g, button.getButtonText(), Rectangle<int> (-2, 1, button.getWidth(), button.getHeight()),
+                                 Justification::centred))
+                this->textLayoutCache.drawFittedText (g, font, button.getButtonText(),-2, 1,button.getWidth() , button.getHeight(),
+                                                      Justification::centred, 10);
             
             
         }else{
@@ -370,25 +805,53 @@ public:
                          isButtonDown);
             
             g.setColour(button.findColour (ToggleButton::textColourId));
-            g.setFont(this->font);
+            const Font& font = this->scaledFonts.getFont (g.getInternalContext().getPhysicalPixelScaleFactor());
+            g.setFont(font);
             
             if (! button.isEnabled())
                 g.setOpacity (0.5f);
                 
                 const int textX = (int) tickWidth + 5;
             
-            g.drawFittedText (button.getButtonText(),
-                              textX, 0,
-                              button.getWidth() - (textX-5) , button.getHeight(),
-                              Justification::centredLeft, 10);
+            if (! drawAtlasText (g, button.getButtonText(),
+                                 Rectangle<int> (textX, 0, button.getWidth() - (textX-5), button.getHeight()),
+                                 Justification::centredLeft))
+                this->textLayoutCache.drawFittedText (g, font, button.getButtonText(),
+                                                      textX, 0,
+                                                      button.getWidth() - (textX-5) , button.getHeight(),
+                                                      Justification::centredLeft, 10);
         }
     }
     
     void drawTabButton (TabBarButton& button, Graphics& g, bool isMouseOver, bool isMouseDown) override{
+        GRIS_PAINT_ALLOCATION_CHECK ("drawTabButton", false);
+        GRIS_PAINT_PROBE ("drawTabButton", g, &button);
+
+        if (! this->renderMemoEnabled){
+            drawTabButtonShape (button, g, isMouseOver, isMouseDown);
+            return;
+        }
+
+        const Rectangle<int> activeArea (button.getActiveArea());
+        const Rectangle<int> textArea (button.getTextArea());
+        const GrisSpriteKey signature (GrisSpriteKey (tabButtonRender).add (button.getWidth()).add (button.getHeight())
+                                           .add (button.getButtonText()).add (button.getToggleState()).add (button.isEnabled())
+                                           .add (isMouseOver || isMouseDown).add (button.hasKeyboardFocus (false))
+                                           .add (button.getTabBackgroundColour())
+                                           .add ((int) button.getTabbedButtonBar().getOrientation())
+                                           .add (activeArea.getX()).add (activeArea.getY()).add (activeArea.getWidth()).add (activeArea.getHeight())
+                                           .add (textArea.getX()).add (textArea.getY()).add (textArea.getWidth()).add (textArea.getHeight()));
+
+        drawMemoised (g, signature, button.getWidth(), button.getHeight(),
+                      [&] (Graphics& sg) { drawTabButtonShape (button, sg, isMouseOver, isMouseDown); });
+    }
+
+    void drawTabButtonShape (TabBarButton& button, Graphics& g, bool isMouseOver, bool isMouseDown){
         const Rectangle<int> activeArea (button.getActiveArea());
         activeArea.withHeight(18);
         const TabbedButtonBar::Orientation o = button.getTabbedButtonBar().getOrientation();
         const Colour bkg (button.getTabBackgroundColour());
+        const GrisTheme& t = *this->theme;
         
         if (button.getToggleState())
         {
@@ -396,20 +859,19 @@ public:
         }
         else
         {
-            g.setColour (bkg.brighter (0.1f));
+            g.setColour (t.getTabBackground (bkg));
         }
         
         g.fillRect (activeArea);
         
-        g.setColour (this->winBackGroundAndFieldColour);
+        g.setColour (t.winBackground);
         
         Rectangle<int> r (activeArea);
         if (o != TabbedButtonBar::TabsAtTop)      g.fillRect (r.removeFromBottom (1));
             if (o != TabbedButtonBar::TabsAtRight)    g.fillRect (r.removeFromLeft (1));
                 if (o != TabbedButtonBar::TabsAtLeft)     g.fillRect (r.removeFromRight (1));
         
-        const float alpha = button.isEnabled() ? ((isMouseOver || isMouseDown) ? 1.0f : 0.8f) : 0.3f;
-        Colour col = (bkg.contrasting().withMultipliedAlpha (alpha));
+        Colour col = t.getTabText (bkg, button.isEnabled(), isMouseOver || isMouseDown);
         const Rectangle<float> area (button.getTextArea().toFloat());
         
         float length = area.getWidth();
@@ -418,9 +880,8 @@ public:
         if (button.getTabbedButtonBar().isVertical())
             std::swap (length, depth);
             
-        TextLayout textLayout;
-        createTabTextLayout (button, length, depth, col, textLayout);
-        textLayout.draw (g, Rectangle<float> (length, depth));
+        this->textLayoutCache.drawText (g, getTabFont (button, depth, g.getInternalContext().getPhysicalPixelScaleFactor()), button.getButtonText().trim(), col,
+                                        Justification::centred, length, Rectangle<float> (length, depth));
         /*
         Rectangle<int> activeArea (button.getActiveArea());
 
@@ -460,20 +921,17 @@ public:
         textLayout.draw (g, Rectangle<float> (length, depth));*/
     }
     
-    void createTabTextLayout (const TabBarButton& button, float length, float depth, Colour colour, TextLayout& textLayout)
+    // tabs of a bar share one depth, so this only rebuilds the font when focus moves
+    const Font& getTabFont (const TabBarButton& button, float depth, float scale)
     {
-        Font font (this->font);
-#if WIN32
-        font.setHeight(depth * 0.60f);
-#else
+        return this->scaledFonts.getTabFont (depth, button.hasKeyboardFocus (false), scale);
+    }
 
-        font.setHeight(depth * 0.35f);
-#endif
-        font.setUnderline (button.hasKeyboardFocus (false));
-        
+    void createTabTextLayout (const TabBarButton& button, float length, float depth, Colour colour, TextLayout& textLayout)
+    {
         AttributedString s;
         s.setJustification (Justification::centred);
-        s.append (button.getButtonText().trim(), font, colour);
+        s.append (button.getButtonText().trim(), getTabFont (button, depth, getComponentScale (const_cast<TabBarButton&> (button))), colour);
         
         textLayout.createLayout (s, length);
     }
@@ -533,6 +991,55 @@ public:
         //    //we don't use those, so far
     void drawRotarySlider (Graphics& g, int x, int y, int width, int height, float sliderPos,
                            float rotaryStartAngle, float rotaryEndAngle, Slider& slider) override
+    {
+        GRIS_PAINT_ALLOCATION_CHECK ("drawRotarySlider", false);
+        GRIS_PAINT_PROBE ("drawRotarySlider", g, &slider);
+
+        const bool isMouseOver = slider.isMouseOverOrDragging() && slider.isEnabled();
+        //slider.findColour (Slider::rotarySliderFillColourId).withAlpha (isMouseOver ? 0.7f : 1.0f)
+        const Colour colour (this->theme->getColour (GrisTheme::rotarySlider, GrisTheme::getState (slider.isEnabled(), false, isMouseOver, false)));
+
+        if (! this->rotaryFilmstripEnabled || width <= 0 || height <= 0){
+            const float angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
+            drawRotarySliderShape (g, (float) x, (float) y, width, height, angle, rotaryStartAngle, rotaryEndAngle, colour);
+            return;
+        }
+
+        const int   numFrames = this->rotaryFilmstripFrames;
+        const int   frame = jlimit (0, numFrames - 1, roundToInt (sliderPos * (numFrames - 1)));
+        const Image sprite (getRotaryFrameSprite (width, height, rotaryStartAngle, rotaryEndAngle, colour, frame, numFrames,
+                                                  g.getInternalContext().getPhysicalPixelScaleFactor()));
+
+        g.drawImage (sprite, x, y, width, height, 0, 0, sprite.getWidth(), sprite.getHeight());
+    }
+
+    /** One frame of the rotary filmstrip, rendered on first use. Thread safe. */
+    Image getRotaryFrameSprite (int width, int height, float rotaryStartAngle, float rotaryEndAngle,
+                                const Colour& colour, int frame, int numFrames, float scale)
+    {
+        const uint64 key = GrisSpriteKey (rotaryFilmstripSprite).add (width).add (height).add (scale)
+                                                                 .add (rotaryStartAngle).add (rotaryEndAngle)
+                                                                 .add (colour).add (frame).get();
+        Image sprite (this->rotaryFilmstripCache.get (key));
+
+        if (! sprite.isValid()){
+            const float angle = rotaryStartAngle + (frame / (float) (numFrames - 1)) * (rotaryEndAngle - rotaryStartAngle);
+            sprite = Image (Image::ARGB, jmax (1, roundToInt (width * scale)), jmax (1, roundToInt (height * scale)), true);
+            Graphics sg (sprite);
+            sg.addTransform (AffineTransform::scale (scale));
+            drawRotarySliderShape (sg, 0.0f, 0.0f, width, height, angle, rotaryStartAngle, rotaryEndAngle, colour);
+            this->rotaryFilmstripCache.put (key, sprite);
+        }
+
+        return sprite;
+    }
+
+    int getRotaryFilmstripFrames() const{
+        return this->rotaryFilmstripFrames;
+    }
+
+    void drawRotarySliderShape (Graphics& g, float x, float y, int width, int height, float angle,
+                                float rotaryStartAngle, float rotaryEndAngle, const Colour& colour)
     {
         const float radius = jmin (width / 2, height / 2) - 2.0f;
         const float centreX = x + width * 0.5f;
@@ -540,21 +1047,8 @@ public:
         const float rx = centreX - radius;
         const float ry = centreY - radius;
         const float rw = radius * 2.0f;
-        const float angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
-        const bool isMouseOver = slider.isMouseOverOrDragging() && slider.isEnabled();
-        
-        if (slider.isEnabled()){
-            //slider.findColour (Slider::rotarySliderFillColourId).withAlpha (isMouseOver ? 0.7f : 1.0f)
-            if(isMouseOver){
-                g.setColour (this->onColorOver);
-            }
-            else{
-                g.setColour (this->onColor);
-            }
-        }
-        else{
-                g.setColour (this->offColor);
-        }
+
+        g.setColour (colour);
         Path filledArc;
         filledArc.addPieSegment (rx, ry, rw, rw, rotaryStartAngle, angle, 0.0);
         g.fillPath (filledArc);
@@ -565,5 +1059,16 @@ public:
     }
 };
 
+//==============================================================================
+/** One GrisLookAndFeel for the whole process.
+
+ Plugin editors should hold a GrisSharedLookAndFeel member and pass it to setLookAndFeel():
+ the look and feel is built for the first editor and deleted with the last one, so that hosts
+ running dozens of instances only pay for the typeface and the palette once. Fonts and glyph
+ atlases follow the scale of the component or Graphics context they are drawn for, so editors
+ at different zoom levels can share it.
+ */
+typedef SharedResourcePointer<GrisLookAndFeel> GrisSharedLookAndFeel;
+
 #endif
 
@@ -0,0 +1,685 @@
+/*
+ ==============================================================================
+
+ GrisLookAndFeelBenchmark.h
+
+ Headless timing of the GrisLookAndFeel draw overrides, rendered with the
+ software renderer into offscreen images.
+
+ ==============================================================================
+ */
+
+#ifndef GRISLOOKANDFEELBENCHMARK_H_INCLUDED
+#define GRISLOOKANDFEELBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisAllocationCounter.h"
+#include "GrisDeltaSlider.h"
+#include "GrisFieldRenderer.h"
+#include "GrisLevelMeterBank.h"
+#include "GrisLookAndFeel.h"
+#include "GrisNumericReadout.h"
+#include "GrisSignalDisplay.h"
+#include "GrisTiledRenderer.h"
+
+//==============================================================================
+/** Runs every draw override of a GrisLookAndFeel over a matrix of sizes, scale
+ factors and widget states, and reports ns/call and allocations/call.
+
+ This is meant to be driven from a small console application linked with
+ juce_gui_basics and juce_audio_basics, such as Benchmark/Main.cpp, e.g.
+
+ @code
+ GRIS_DEFINE_ALLOCATION_COUNTING_OPERATORS
+
+ int main()
+ {
+     ScopedJuceInitialiser_GUI juce;
+     GrisLookAndFeel lnf;
+     GrisLookAndFeelBenchmark bench (lnf);
+     bench.run();
+     std::cout << bench.toJson();
+ }
+ @endcode
+
+ Allocations are only counted when the application expands
+ GRIS_DEFINE_ALLOCATION_COUNTING_OPERATORS, otherwise they are reported as -1.
+ Hover and down states are passed to the overrides that take them as arguments;
+ overrides that query the component itself only see the enabled and toggle states.
+ The toggle state is a dimension of its own, crossed with every mouse state, for the
+ overrides that draw one.
+ */
+class GrisLookAndFeelBenchmark {
+public:
+    enum Override {
+        comboBox = 0,
+        buttonBackground,
+        tickBox,
+        linearSlider,
+        rotarySlider,
+        toggleButton,
+        tabButton,
+        roundThumb,
+        roundThumbUncached,
+        toggleButtonMemoised,
+        tabButtonMemoised,
+        numOverrides
+    };
+
+    enum State { normal = 0, hover, down, disabled, numStates };
+
+    struct Result {
+        String name;
+        String state;
+        int width, height;
+        float scale;
+        int iterations;
+        double nsPerCall;
+        double allocationsPerCall;
+
+        /** Only known for the measurements that paint through a clip region. */
+        double pixelsPerCall = -1.0;
+
+        /** Set by the measurements that simulate a refresh rate, to report CPU use per second. */
+        double callsPerSecond = 0.0;
+
+        double getCpuPercent() const{
+            return this->callsPerSecond > 0.0 ? this->nsPerCall * this->callsPerSecond * 1.0e-7 : -1.0;
+        }
+    };
+
+    explicit GrisLookAndFeelBenchmark (GrisLookAndFeel& lookAndFeelToTest)
+        : lnf (lookAndFeelToTest),
+          tabBar (TabbedButtonBar::TabsAtTop),
+          iterations (200)
+    {
+        this->sizes.add (Rectangle<int> (24, 24));
+        this->sizes.add (Rectangle<int> (120, 24));
+        this->sizes.add (Rectangle<int> (240, 60));
+        this->scales.add (1.0f);
+        this->scales.add (2.0f);
+
+        this->comboBoxComponent.addItem ("Item", 1);
+        this->comboBoxComponent.setSelectedId (1, dontSendNotification);
+        this->textButton.setButtonText ("Button");
+        this->toggle.setButtonText ("Toggle");
+        this->numberToggle.setButtonText ("1");
+        this->linearSliderComponent.setSliderStyle (Slider::LinearHorizontal);
+        this->linearSliderComponent.setRange (0.0, 1.0);
+        this->linearSliderComponent.setValue (0.5, dontSendNotification);
+        this->rotarySliderComponent.setSliderStyle (Slider::Rotary);
+        this->rotarySliderComponent.setRange (0.0, 1.0);
+        this->rotarySliderComponent.setValue (0.5, dontSendNotification);
+        this->tabBar.addTab ("Tab", this->lnf.getBackgroundColour(), -1);
+
+        Component* const components[] = { &this->comboBoxComponent, &this->textButton, &this->toggle,
+                                          &this->numberToggle, &this->linearSliderComponent,
+                                          &this->rotarySliderComponent, &this->tabBar };
+
+        for (int i = 0; i < numElementsInArray (components); ++i)
+            components[i]->setLookAndFeel (&this->lnf);
+    }
+
+    ~GrisLookAndFeelBenchmark(){
+        Component* const components[] = { &this->comboBoxComponent, &this->textButton, &this->toggle,
+                                          &this->numberToggle, &this->linearSliderComponent,
+                                          &this->rotarySliderComponent, &this->tabBar };
+
+        for (int i = 0; i < numElementsInArray (components); ++i)
+            components[i]->setLookAndFeel (nullptr);
+    }
+
+    void setIterations (int numIterations)                   { this->iterations = jmax (1, numIterations); }
+    void setSizes (const Array<Rectangle<int>>& newSizes)    { this->sizes = newSizes; }
+    void setScales (const Array<float>& newScales)           { this->scales = newScales; }
+
+    /** Runs the whole matrix, replacing any previous results. */
+    void run(){
+        this->results.clearQuick();
+
+        this->results.add (measureLevelMeterBank (256, 1024, 200, 2));
+        this->results.add (measureSliderAutomation (64, 200, 24, 60, false));
+        this->results.add (measureSliderAutomation (64, 200, 24, 60, true));
+        this->results.add (measureFieldRenderer (128, 64, 800, 600));
+        this->results.add (measureFieldRenderer (1000, 512, 800, 600));
+        this->results.add (measureSignalDisplay (1, 800, 120, 48000.0));
+        this->results.add (measureSignalDisplay (16, 800, 960, 96000.0));
+        this->results.add (measureNumericReadouts (256, false));
+        this->results.add (measureNumericReadouts (256, true));
+
+        for (int threads = 1; threads <= SystemStats::getNumCpus(); threads *= 2)
+            this->results.add (measureTiledRendering (threads, 1600, 900));
+
+        for (int o = 0; o < numOverrides; ++o)
+            for (int i = 0; i < this->sizes.size(); ++i)
+                for (int s = 0; s < this->scales.size(); ++s)
+                    for (int st = 0; st < numStates; ++st)
+                        for (int on = 0; on < (drawsToggleState ((Override) o) ? 2 : 1); ++on)
+                            this->results.add (measure ((Override) o, this->sizes[i].getWidth(), this->sizes[i].getHeight(),
+                                                        this->scales[s], (State) st, on != 0));
+    }
+
+    /** True for the overrides whose pixels depend on the toggle state of their button. */
+    static bool drawsToggleState (Override which){
+        return which == tickBox || which == toggleButton || which == toggleButtonMemoised;
+    }
+
+    /** Times a single cell of the matrix. */
+    Result measure (Override which, int width, int height, float scale, State state, bool toggledOn = false){
+        Image image (Image::ARGB, jmax (1, roundToInt (width * scale)), jmax (1, roundToInt (height * scale)),
+                     true, SoftwareImageType());
+        Graphics g (image);
+        g.addTransform (AffineTransform::scale (scale));
+
+        // made now rather than on the worker pool, so that text is blitted from the start
+        this->lnf.getGlyphAtlas (scale);
+        prepare (width, height, state, toggledOn);
+
+        const bool thumbCacheWasEnabled = this->lnf.isRoundThumbCacheEnabled();
+        this->lnf.setRoundThumbCacheEnabled (which != roundThumbUncached);
+
+        const bool memoWasEnabled = this->lnf.isRenderMemoisationEnabled();
+        this->lnf.setRenderMemoisationEnabled (which == toggleButtonMemoised || which == tabButtonMemoised);
+
+        for (int i = 0; i < 10; ++i)
+            drawOnce (which, g, width, height, state, toggledOn);
+
+        const long long allocationsBefore = GrisAllocationCounter::getCount();
+        const int64 start = Time::getHighResolutionTicks();
+
+        for (int i = 0; i < this->iterations; ++i)
+            drawOnce (which, g, width, height, state, toggledOn);
+
+        const int64 end = Time::getHighResolutionTicks();
+        const long long allocations = GrisAllocationCounter::getCount() - allocationsBefore;
+
+        this->lnf.setRoundThumbCacheEnabled (thumbCacheWasEnabled);
+        this->lnf.setRenderMemoisationEnabled (memoWasEnabled);
+
+        Result r;
+        r.name = getOverrideName (which);
+        r.state = getStateName (state) + (toggledOn ? " (on)" : "");
+        r.width = width;
+        r.height = height;
+        r.scale = scale;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (end - start) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        return r;
+    }
+
+    /** Paint cost of one GrisLevelMeterBank frame in which a quarter of the channels move. */
+    Result measureLevelMeterBank (int numChannels, int width, int height, int numRows){
+        GrisMeterLevels meterLevels (numChannels);
+        GrisLevelMeterBank bank (this->lnf, meterLevels, numRows);
+        bank.setSize (width, height);
+
+        Image image (Image::RGB, width, height, true, SoftwareImageType());
+        Random random (1);
+        int64 ticks = 0, pixels = 0;
+        long long allocations = 0;
+
+        for (int frame = -10; frame < this->iterations; ++frame){
+            for (int i = 0; i < numChannels / 4; ++i)
+                meterLevels.setLevel (random.nextInt (numChannels), random.nextFloat());
+
+            const long long allocationsBefore = GrisAllocationCounter::getCount();
+            const int64 start = Time::getHighResolutionTicks();
+
+            const RectangleList<int> changed (bank.collectChangedBars());
+            Graphics g (image);
+            g.reduceClipRegion (changed);
+            bank.paint (g);
+
+            if (frame >= 0){
+                ticks += Time::getHighResolutionTicks() - start;
+                allocations += GrisAllocationCounter::getCount() - allocationsBefore;
+
+                for (const Rectangle<int>* r = changed.begin(); r != changed.end(); ++r)
+                    pixels += r->getWidth() * r->getHeight();
+            }
+        }
+
+        Result r;
+        r.name = "GrisLevelMeterBank/" + String (numChannels);
+        r.state = "quarter changed";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        r.pixelsPerCall = pixels / (double) this->iterations;
+        r.callsPerSecond = 30.0;
+        return r;
+    }
+
+    /** Cost of one automation frame of numSliders linear sliders, each following a slow sweep.
+
+     With deltaRepaint, GrisDeltaSlider paints only the area it would invalidate; otherwise
+     drawLinearSlider() paints the whole slider, as a juce::Slider repaints on every change.
+     The CPU use reported is for updatesPerSecond frames a second.
+     */
+    Result measureSliderAutomation (int numSliders, int width, int height, int updatesPerSecond, bool deltaRepaint){
+        OwnedArray<GrisDeltaSlider> deltaSliders;
+        for (int i = 0; i < numSliders; ++i)
+            deltaSliders.add (new GrisDeltaSlider (this->lnf))->setSize (width, height);
+
+        this->linearSliderComponent.setEnabled (true);
+        this->linearSliderComponent.setSize (width, height);
+        const int radius = this->lnf.getSliderThumbRadius (this->linearSliderComponent);
+
+        Image image (Image::ARGB, width, height, true, SoftwareImageType());
+        int64 ticks = 0, pixels = 0;
+        long long allocations = 0;
+
+        for (int frame = -10; frame < this->iterations; ++frame){
+            const long long allocationsBefore = GrisAllocationCounter::getCount();
+            const int64 start = Time::getHighResolutionTicks();
+            int64 framePixels = 0;
+
+            for (int i = 0; i < numSliders; ++i){
+                // a quarter of a cycle per second, each slider out of phase with the others
+                const double value = 0.5 + 0.5 * std::sin (2.0 * double_Pi * (frame * 0.25 / updatesPerSecond + i / (double) numSliders));
+
+                if (deltaRepaint){
+                    GrisDeltaSlider& s = *deltaSliders.getUnchecked (i);
+                    const Rectangle<int> area (s.getRepaintArea (s.getValue(), value));
+                    s.setValue (value, dontSendNotification);
+
+                    if (! area.isEmpty()){
+                        Graphics g (image);
+                        g.reduceClipRegion (area);
+                        s.paint (g);
+                        framePixels += area.getWidth() * area.getHeight();
+                    }
+                }else{
+                    this->linearSliderComponent.setValue (value, dontSendNotification);
+                    const float sliderPos = radius + (float) value * (width - 2 * radius);
+                    Graphics g (image);
+                    this->lnf.drawLinearSlider (g, radius, 0, width - 2 * radius, height, sliderPos, (float) radius,
+                                                (float) (width - radius), Slider::LinearHorizontal, this->linearSliderComponent);
+                    framePixels += width * height;
+                }
+            }
+
+            if (frame >= 0){
+                ticks += Time::getHighResolutionTicks() - start;
+                allocations += GrisAllocationCounter::getCount() - allocationsBefore;
+                pixels += framePixels;
+            }
+        }
+
+        Result r;
+        r.name = (deltaRepaint ? "GrisDeltaSlider/" : "drawLinearSlider/") + String (numSliders);
+        r.state = "automated";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        r.pixelsPerCall = pixels / (double) this->iterations;
+        r.callsPerSecond = updatesPerSecond;
+        return r;
+    }
+
+    /** One frame of a GrisFieldRenderer scene in which every source moves and the view turns. */
+    Result measureFieldRenderer (int numSources, int numSpeakers, int width, int height){
+        GrisFieldPoints points (numSources + numSpeakers);
+        GrisFieldRenderer renderer (this->lnf);
+        points.setNumPoints (numSources + numSpeakers);
+
+        Random random (1);
+        for (int i = 0; i < numSpeakers; ++i){
+            const float azimuth = random.nextFloat() * 2.0f * float_Pi;
+            const float elevation = random.nextFloat() * 0.5f * float_Pi;
+            points.setPoint (numSources + i, std::cos (azimuth) * std::cos (elevation), std::sin (azimuth) * std::cos (elevation),
+                             std::sin (elevation), GrisFieldPoints::speaker);
+        }
+
+        Image image (Image::RGB, width, height, true, SoftwareImageType());
+        int64 ticks = 0;
+        long long allocations = 0;
+
+        for (int frame = -10; frame < this->iterations; ++frame){
+            for (int i = 0; i < numSources; ++i){
+                const float angle = (i + frame * 0.01f) * 0.37f;
+                points.setPoint (i, std::cos (angle) * 0.8f, std::sin (angle) * 0.8f, (i % 10) * 0.1f, GrisFieldPoints::source);
+            }
+
+            const long long allocationsBefore = GrisAllocationCounter::getCount();
+            const int64 start = Time::getHighResolutionTicks();
+
+            Graphics g (image);
+            g.fillAll (this->lnf.getWinBackgroundColour());
+            renderer.setViewAngles (frame * 0.01f, 0.6f);
+            renderer.project (points, image.getBounds().toFloat());
+            renderer.draw (g, points);
+
+            if (frame >= 0){
+                ticks += Time::getHighResolutionTicks() - start;
+                allocations += GrisAllocationCounter::getCount() - allocationsBefore;
+            }
+        }
+
+        Result r;
+        r.name = "GrisFieldRenderer/" + String (numSources) + "x" + String (numSpeakers);
+        r.state = "moving";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        r.pixelsPerCall = width * (double) height;
+        r.callsPerSecond = 60.0;
+        return r;
+    }
+
+    /** One 60 fps frame of a GrisSignalDisplay: reducing a frame's worth of audio on every
+        channel and painting the waveform. Divide by numChannels for the cost per channel.
+     */
+    Result measureSignalDisplay (int numChannels, int width, int height, double sampleRate){
+        const int samplesPerFrame = roundToInt (sampleRate / 60.0);
+        GrisSignalDisplay display (this->lnf, numChannels, 512, samplesPerFrame * 4);
+        display.setTimeSpan (2.0, sampleRate);
+        display.setSize (width, height);
+
+        AudioSampleBuffer block (numChannels, samplesPerFrame);
+        Random random (1);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < samplesPerFrame; ++i)
+                block.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+        Image image (Image::RGB, width, height, true, SoftwareImageType());
+        int64 ticks = 0;
+        long long allocations = 0;
+
+        for (int frame = -10; frame < this->iterations; ++frame){
+            display.pushBlock (block.getArrayOfReadPointers(), samplesPerFrame);
+
+            const long long allocationsBefore = GrisAllocationCounter::getCount();
+            const int64 start = Time::getHighResolutionTicks();
+
+            display.consume();
+            Graphics g (image);
+            display.paint (g);
+
+            if (frame >= 0){
+                ticks += Time::getHighResolutionTicks() - start;
+                allocations += GrisAllocationCounter::getCount() - allocationsBefore;
+            }
+        }
+
+        Result r;
+        r.name = "GrisSignalDisplay/" + String (numChannels) + "ch@" + String (roundToInt (sampleRate / 1000.0)) + "k";
+        r.state = "waveform";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        r.pixelsPerCall = width * (double) height;
+        r.callsPerSecond = 60.0;
+        return r;
+    }
+
+    /** Draws a grid of changing dB readouts, through GrisNumericReadout or with
+        Graphics::drawText as a label would, once per frame at 60 Hz.
+     */
+    Result measureNumericReadouts (int numReadouts, bool useGlyphAtlas){
+        const int cellW = 64, cellH = 18, columns = 16;
+        const int width = cellW * columns;
+        const int height = cellH * ((numReadouts + columns - 1) / columns);
+        GrisNumericReadout readout (this->lnf, 1, " dB");
+        const Font font (this->lnf.getScaledFont (1.0f));
+
+        Image image (Image::RGB, width, height, true, SoftwareImageType());
+        int64 ticks = 0;
+        long long allocations = 0;
+
+        for (int frame = -10; frame < this->iterations; ++frame){
+            const long long allocationsBefore = GrisAllocationCounter::getCount();
+            const int64 start = Time::getHighResolutionTicks();
+
+            Graphics g (image);
+            g.setColour (this->lnf.getLightColour());
+            g.setFont (font);
+
+            for (int i = 0; i < numReadouts; ++i){
+                const Rectangle<float> cell ((float) ((i % columns) * cellW), (float) ((i / columns) * cellH), (float) cellW, (float) cellH);
+                const double value = -60.0 + std::fmod (i * 7.3 + frame * 0.37, 66.0);
+
+                if (useGlyphAtlas)
+                    readout.draw (g, value, cell, Justification::centredRight);
+                else
+                    g.drawText (String (value, 1) + " dB", cell, Justification::centredRight, false);
+            }
+
+            if (frame >= 0){
+                ticks += Time::getHighResolutionTicks() - start;
+                allocations += GrisAllocationCounter::getCount() - allocationsBefore;
+            }
+        }
+
+        Result r;
+        r.name = "GrisNumericReadout/" + String (numReadouts);
+        r.state = useGlyphAtlas ? "glyph atlas" : "drawText";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = this->iterations;
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / this->iterations;
+        r.allocationsPerCall = GrisAllocationCounter::isActive() ? allocations / (double) this->iterations : -1.0;
+        r.pixelsPerCall = width * (double) height;
+        r.callsPerSecond = 60.0;
+        return r;
+    }
+
+    /** A full repaint of an editor made of 8 panels of 24 rotary sliders, painted by a
+        GrisTiledRenderer with numThreads threads. The state names the number of pixels
+        that differ from the serial paint, which should be 0.
+     */
+    Result measureTiledRendering (int numThreads, int width, int height){
+        Component editor;
+        OwnedArray<Component> panels;
+        OwnedArray<Slider> sliders;
+        editor.setSize (width, height);
+
+        for (int p = 0; p < 8; ++p){
+            Component* panel = panels.add (new Component());
+            panel->setBounds ((p % 4) * width / 4, (p / 4) * height / 2, width / 4, height / 2);
+            editor.addAndMakeVisible (panel);
+
+            for (int i = 0; i < 24; ++i){
+                Slider* s = sliders.add (new Slider (Slider::Rotary, Slider::NoTextBox));
+                s->setLookAndFeel (&this->lnf);
+                s->setRange (0.0, 1.0);
+                s->setValue (i / 24.0, dontSendNotification);
+                s->setBounds ((i % 6) * panel->getWidth() / 6, (i / 6) * panel->getHeight() / 4, panel->getWidth() / 6, panel->getHeight() / 4);
+                panel->addAndMakeVisible (s);
+            }
+        }
+
+        const int numDifferent = GrisTiledRenderer::compareWithSerial (editor, 1.0f, numThreads);
+        GrisTiledRenderer* renderer = GrisTiledRenderer::enable (editor, numThreads);
+        Image image (Image::ARGB, width, height, true, SoftwareImageType());
+        int64 ticks = 0;
+
+        for (int frame = -2; frame < jmax (1, this->iterations / 10); ++frame){
+            const int64 start = Time::getHighResolutionTicks();
+
+            renderer->invalidateAll();
+            Graphics g (image);
+            renderer->paint (g);
+
+            if (frame >= 0)
+                ticks += Time::getHighResolutionTicks() - start;
+        }
+
+        GrisTiledRenderer::disable (editor);
+        for (int i = 0; i < sliders.size(); ++i)
+            sliders.getUnchecked (i)->setLookAndFeel (nullptr);
+
+        Result r;
+        r.name = "GrisTiledRenderer/" + String (numThreads) + " threads";
+        r.state = String (numDifferent) + " px differ";
+        r.width = width;
+        r.height = height;
+        r.scale = 1.0f;
+        r.iterations = jmax (1, this->iterations / 10);
+        r.nsPerCall = Time::highResolutionTicksToSeconds (ticks) * 1.0e9 / r.iterations;
+        r.allocationsPerCall = -1.0;
+        r.pixelsPerCall = width * (double) height;
+        return r;
+    }
+
+    const Array<Result>& getResults() const{
+        return this->results;
+    }
+
+    String toCsv() const{
+        String s ("override,state,width,height,scale,iterations,ns_per_call,allocations_per_call,pixels_per_call,cpu_percent\n");
+
+        for (int i = 0; i < this->results.size(); ++i){
+            const Result& r = this->results.getReference (i);
+            s << r.name << ',' << r.state << ',' << r.width << ',' << r.height << ',' << r.scale << ','
+              << r.iterations << ',' << String (r.nsPerCall, 1) << ',' << String (r.allocationsPerCall, 3) << ','
+              << String (r.pixelsPerCall, 1) << ',' << String (r.getCpuPercent(), 3) << '\n';
+        }
+
+        return s;
+    }
+
+    String toJson() const{
+        Array<var> rows;
+
+        for (int i = 0; i < this->results.size(); ++i){
+            const Result& r = this->results.getReference (i);
+            DynamicObject::Ptr row (new DynamicObject());
+            row->setProperty ("override", r.name);
+            row->setProperty ("state", r.state);
+            row->setProperty ("width", r.width);
+            row->setProperty ("height", r.height);
+            row->setProperty ("scale", r.scale);
+            row->setProperty ("iterations", r.iterations);
+            row->setProperty ("ns_per_call", r.nsPerCall);
+            row->setProperty ("allocations_per_call", r.allocationsPerCall);
+            row->setProperty ("pixels_per_call", r.pixelsPerCall);
+            row->setProperty ("cpu_percent", r.getCpuPercent());
+            rows.add (var (row.get()));
+        }
+
+        return JSON::toString (var (rows));
+    }
+
+    static String getOverrideName (Override which){
+        switch (which){
+            case comboBox:          return "drawComboBox";
+            case buttonBackground:  return "drawButtonBackground";
+            case tickBox:           return "drawTickBox";
+            case linearSlider:      return "drawLinearSlider";
+            case rotarySlider:      return "drawRotarySlider";
+            case toggleButton:      return "drawToggleButton";
+            case tabButton:         return "drawTabButton";
+            case roundThumb:        return "drawRoundThumb";
+            case roundThumbUncached:return "drawRoundThumb (uncached)";
+            case toggleButtonMemoised:  return "drawToggleButton (memoised)";
+            case tabButtonMemoised:     return "drawTabButton (memoised)";
+            default:                break;
+        }
+        return String();
+    }
+
+    static String getStateName (State state){
+        switch (state){
+            case normal:    return "normal";
+            case hover:     return "hover";
+            case down:      return "down";
+            case disabled:  return "disabled";
+            default:        break;
+        }
+        return String();
+    }
+
+private:
+    void prepare (int width, int height, State state, bool toggledOn){
+        const bool enabled = state != disabled;
+        Component* const components[] = { &this->comboBoxComponent, &this->textButton, &this->toggle,
+                                          &this->numberToggle, &this->linearSliderComponent,
+                                          &this->rotarySliderComponent, &this->tabBar };
+
+        for (int i = 0; i < numElementsInArray (components); ++i){
+            components[i]->setEnabled (enabled);
+            components[i]->setSize (width, height);
+        }
+
+        this->toggle.setToggleState (toggledOn, dontSendNotification);
+        this->numberToggle.setToggleState (toggledOn, dontSendNotification);
+
+        if (TabBarButton* tab = this->tabBar.getTabButton (0))
+            tab->setBounds (0, 0, width, height);
+    }
+
+    void drawOnce (Override which, Graphics& g, int width, int height, State state, bool toggledOn){
+        const bool isOver = state == hover || state == down;
+        const bool isDown = state == down;
+
+        switch (which){
+            case comboBox:
+                this->lnf.drawComboBox (g, width, height, isDown, width - height, 0, height, height, this->comboBoxComponent);
+                break;
+            case buttonBackground:
+                this->lnf.drawButtonBackground (g, this->textButton, this->lnf.getBackgroundColour(), isOver, isDown);
+                break;
+            case tickBox:
+                this->lnf.drawTickBox (g, this->toggle, 0.0f, 0.0f, (float) width, (float) height,
+                                       toggledOn, state != disabled, isOver, isDown);
+                break;
+            case linearSlider:
+                this->lnf.drawLinearSlider (g, 0, 0, width, height, width * 0.5f, 0.0f, (float) width,
+                                            Slider::LinearHorizontal, this->linearSliderComponent);
+                break;
+            case rotarySlider:
+                this->lnf.drawRotarySlider (g, 0, 0, width, height, 0.5f, float_Pi * 1.2f, float_Pi * 2.8f,
+                                            this->rotarySliderComponent);
+                break;
+            case toggleButton:
+            case toggleButtonMemoised:
+                this->lnf.drawToggleButton (g, width <= height ? this->numberToggle : this->toggle, isOver, isDown);
+                break;
+            case tabButton:
+            case tabButtonMemoised:
+                if (TabBarButton* tab = this->tabBar.getTabButton (0))
+                    this->lnf.drawTabButton (*tab, g, isOver, isDown);
+                break;
+            case roundThumb:
+            case roundThumbUncached:
+                this->lnf.drawRoundThumb (g, 0.0f, 0.0f, (float) jmin (width, height),
+                                          state == disabled ? this->lnf.getOffColour() : this->lnf.getOnColour(), 1.0f);
+                break;
+            default:
+                jassertfalse;
+                break;
+        }
+    }
+
+    GrisLookAndFeel& lnf;
+
+    ComboBox comboBoxComponent;
+    TextButton textButton;
+    ToggleButton toggle, numberToggle;
+    Slider linearSliderComponent, rotarySliderComponent;
+    TabbedButtonBar tabBar;
+
+    Array<Rectangle<int>> sizes;
+    Array<float> scales;
+    Array<Result> results;
+    int iterations;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisLookAndFeelBenchmark)
+};
+
+#endif
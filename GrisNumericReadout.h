@@ -0,0 +1,282 @@
+/*
+ ==============================================================================
+
+ GrisNumericReadout.h
+
+ Numeric readouts drawn by blitting the glyph atlas of the look and feel font,
+ for values that change on every frame such as azimuth, elevation or levels.
+
+ ==============================================================================
+ */
+
+#ifndef GRISNUMERICREADOUT_H_INCLUDED
+#define GRISNUMERICREADOUT_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+
+#include <cstring>
+
+//==============================================================================
+/** Formats a value into a fixed character buffer and draws it from a GrisGlyphAtlas.
+
+ Neither formatting nor drawing allocates: the text is built digit by digit in a
+ char array, and each character is one blit of a pre-rasterised glyph, so a value
+ costs a few image copies instead of a text layout. Digits all advance by the width
+ of the widest one, which keeps the number from shifting as it changes.
+
+ Texts are UTF-8. The atlas holds the printable ASCII characters of the look and
+ feel typeface and the degree sign, so units such as " dB", " m" or " \xc2\xb0" are
+ blitted; a text the atlas cannot draw falls back to Graphics::drawText. The atlas is
+ fetched again only when the display scale or the height changes.
+ */
+class GrisNumericReadout {
+public:
+    enum { maxLength = 32 };
+
+    explicit GrisNumericReadout (GrisLookAndFeel& lookAndFeel, int numDecimalsToShow = 1, const char* unitSuffix = "")
+        : lnf (lookAndFeel), numDecimals (0), showPlusSign (false), fontHeight (0.0f),
+          atlasScale (0.0f), digitAdvance (0.0f), digitTop (0.0f), digitBottom (0.0f)
+    {
+        setNumDecimals (numDecimalsToShow);
+        setSuffix (unitSuffix);
+    }
+
+    void setNumDecimals (int newNumDecimals) noexcept   { this->numDecimals = jlimit (0, 6, newNumDecimals); }
+    void setShowPlusSign (bool shouldShow) noexcept     { this->showPlusSign = shouldShow; }
+
+    /** UTF-8 text drawn after the number, spaces included. */
+    void setSuffix (const char* unitSuffix) noexcept{
+        jassert (std::strlen (unitSuffix) < 12);
+        std::strncpy (this->suffix, unitSuffix, sizeof (this->suffix) - 1);
+        this->suffix[sizeof (this->suffix) - 1] = 0;
+    }
+
+    /** Height of the font in logical pixels; 0, the default, uses the look and feel font. */
+    void setFontHeight (float newHeight) noexcept{
+        this->fontHeight = newHeight;
+        this->atlasScale = 0.0f;
+    }
+
+    int getNumDecimals() const noexcept     { return this->numDecimals; }
+
+    //==============================================================================
+    /** Writes the value with a fixed number of decimals, its sign and a suffix into dest,
+        always null terminated, and returns the number of bytes written. Values are rounded
+        half away from zero and a value rounding to zero has no sign; values too large to
+        show, infinities and NaN are written as "---". A suffix that does not fit is cut
+        between two UTF-8 characters.
+     */
+    static int format (char* dest, int destSize, double value, int numDecimals, bool showPlusSign, const char* suffix) noexcept{
+        jassert (destSize > 0);
+        int n = 0;
+
+        const double factor = std::pow (10.0, numDecimals);
+        const double scaled = std::abs (value) * factor + 0.5;
+
+        if (! (scaled < 1.0e15)){
+            for (const char* c = "---"; *c != 0 && n < destSize - 1; ++c)
+                dest[n++] = *c;
+        }else{
+            const int64 units = (int64) scaled;
+            const int64 divisor = (int64) factor;
+            int64 integerPart = units / divisor;
+            int64 fraction = units % divisor;
+            char digits[24];
+            int numDigits = 0;
+
+            if (units != 0 && (value < 0.0 || showPlusSign) && n < destSize - 1)
+                dest[n++] = value < 0.0 ? '-' : '+';
+
+            do{
+                digits[numDigits++] = (char) ('0' + integerPart % 10);
+                integerPart /= 10;
+            }while (integerPart > 0);
+
+            while (numDigits > 0 && n < destSize - 1)
+                dest[n++] = digits[--numDigits];
+
+            if (numDecimals > 0 && n < destSize - 1)
+                dest[n++] = '.';
+
+            for (int i = 0; i < numDecimals; ++i){
+                digits[i] = (char) ('0' + fraction % 10);
+                fraction /= 10;
+            }
+
+            for (int i = numDecimals; --i >= 0 && n < destSize - 1;)
+                dest[n++] = digits[i];
+        }
+
+        while (*suffix != 0){
+            int numBytes = 1;
+
+            while ((((uint8) suffix[numBytes]) & 0xc0) == 0x80)
+                ++numBytes;
+
+            if (n + numBytes > destSize - 1)
+                break;
+
+            for (int i = 0; i < numBytes; ++i)
+                dest[n++] = *suffix++;
+        }
+
+        dest[n] = 0;
+        return n;
+    }
+
+    /** Formats a value with the settings of this readout. */
+    int format (char* dest, int destSize, double value) const noexcept{
+        return format (dest, destSize, value, this->numDecimals, this->showPlusSign, this->suffix);
+    }
+
+    //==============================================================================
+    /** Draws a value in an area with the current colour of g; the text is centred
+        vertically on its digits and placed horizontally by the justification.
+     */
+    void draw (Graphics& g, double value, const Rectangle<float>& area, Justification justification){
+        char text[maxLength];
+        format (text, maxLength, value);
+        drawText (g, text, area, justification);
+    }
+
+    /** Draws text already formatted, e.g. by format(), the same way. */
+    void drawText (Graphics& g, const char* text, const Rectangle<float>& area, Justification justification){
+        updateAtlas (g.getInternalContext().getPhysicalPixelScaleFactor());
+
+        if (! this->atlas->canDraw (text)){
+            g.setFont (this->fallbackFont);
+            g.drawText (String::fromUTF8 (text), area, justification, false);
+            return;
+        }
+
+        const float width = getTextWidth (text);
+        float x = area.getX();
+
+        if (justification.testFlags (Justification::horizontallyCentred))
+            x = area.getCentreX() - width * 0.5f;
+        else if (justification.testFlags (Justification::right))
+            x = area.getRight() - width;
+
+        const float baseline = area.getCentreY() - (this->digitTop + this->digitBottom) * 0.5f;
+
+        for (CharPointer_UTF8 t (text); ! t.isEmpty();){
+            const juce_wchar c = t.getAndAdvance();
+            const GrisGlyphAtlas::Glyph* glyph = this->atlas->findGlyph (c);
+
+            if (isDigit (c)){
+                // centre the digit in the common digit cell
+                const float glyphAdvance = glyph->advance / this->atlasScale;
+                this->atlas->drawGlyph (g, *glyph, x + (this->digitAdvance - glyphAdvance) * 0.5f, baseline);
+                x += this->digitAdvance;
+            }else{
+                x = this->atlas->drawGlyph (g, *glyph, x, baseline);
+            }
+        }
+    }
+
+    /** Width of a formatted text in logical pixels, at the scale last drawn. */
+    float getTextWidth (const char* text) const noexcept{
+        float width = 0.0f;
+
+        if (this->atlas == nullptr)
+            return width;
+
+        for (CharPointer_UTF8 t (text); ! t.isEmpty();){
+            const juce_wchar c = t.getAndAdvance();
+
+            if (isDigit (c))
+                width += this->digitAdvance;
+            else if (const GrisGlyphAtlas::Glyph* glyph = this->atlas->findGlyph (c))
+                width += glyph->advance / this->atlasScale;
+        }
+
+        return width;
+    }
+
+private:
+    static bool isDigit (juce_wchar c) noexcept { return c >= '0' && c <= '9'; }
+
+    void updateAtlas (float scale){
+        if (scale == this->atlasScale && this->atlas != nullptr)
+            return;
+
+        this->atlasScale = scale;
+        this->atlas = this->fontHeight > 0.0f ? this->lnf.getGlyphAtlas (scale, this->fontHeight)
+                                              : this->lnf.getGlyphAtlas (scale);
+        this->fallbackFont = this->lnf.getScaledFont (scale).withHeight (this->atlas->getHeight());
+        this->digitAdvance = 0.0f;
+        this->digitTop = 0.0f;
+        this->digitBottom = 0.0f;
+
+        for (char c = '0'; c <= '9'; ++c){
+            if (const GrisGlyphAtlas::Glyph* glyph = this->atlas->findGlyph ((juce_wchar) c)){
+                this->digitAdvance = jmax (this->digitAdvance, glyph->advance / scale);
+                this->digitTop = jmin (this->digitTop, glyph->yOffset / scale);
+                this->digitBottom = jmax (this->digitBottom, (glyph->yOffset + glyph->height) / scale);
+            }
+        }
+    }
+
+    GrisLookAndFeel& lnf;
+    int numDecimals;
+    bool showPlusSign;
+    char suffix[12];
+    float fontHeight;
+
+    GrisGlyphAtlas::Ptr atlas;
+    Font fallbackFont;
+    float atlasScale, digitAdvance, digitTop, digitBottom;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisNumericReadout)
+};
+
+//==============================================================================
+/** A label showing a number through a GrisNumericReadout.
+
+ setValue() formats the value straight away and only repaints when the text
+ differs from the one shown, so a value moving less than its last decimal costs
+ nothing on screen. It can be called at any rate from the message thread.
+ */
+class GrisNumericLabel : public Component {
+public:
+    GrisNumericLabel (GrisLookAndFeel& lookAndFeel, int numDecimalsToShow = 1, const char* unitSuffix = "")
+        : readout (lookAndFeel, numDecimalsToShow, unitSuffix),
+          textColour (lookAndFeel.getLightColour()), justification (Justification::centred)
+    {
+        setInterceptsMouseClicks (false, false);
+        this->text[0] = 0;
+    }
+
+    GrisNumericReadout& getReadout() noexcept   { return this->readout; }
+
+    void setValue (double newValue){
+        char newText[GrisNumericReadout::maxLength];
+        this->readout.format (newText, GrisNumericReadout::maxLength, newValue);
+
+        if (std::strcmp (newText, this->text) != 0){
+            std::strcpy (this->text, newText);
+            repaint();
+        }
+    }
+
+    void setTextColour (Colour newColour)               { this->textColour = newColour; repaint(); }
+    void setJustification (Justification newJustification) { this->justification = newJustification; repaint(); }
+
+    const char* getText() const noexcept    { return this->text; }
+
+    void paint (Graphics& g) override{
+        g.setColour (isEnabled() ? this->textColour : this->textColour.withMultipliedAlpha (0.5f));
+        this->readout.drawText (g, this->text, getLocalBounds().toFloat(), this->justification);
+    }
+
+private:
+    GrisNumericReadout readout;
+    Colour textColour;
+    Justification justification;
+    char text[GrisNumericReadout::maxLength];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisNumericLabel)
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ ==============================================================================
+
+ GrisPaintInstrumentation.h
+
+ Optional profiling of the GrisLookAndFeel draw overrides: call counts, time
+ histograms, painted area and owning component, per override.
+
+ ==============================================================================
+ */
+
+#ifndef GRISPAINTINSTRUMENTATION_H_INCLUDED
+#define GRISPAINTINSTRUMENTATION_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Set GRIS_PAINT_INSTRUMENTATION=1 in the project's preprocessor definitions to
+    profile the look and feel, in any build configuration. When it is 0 (the default)
+    GRIS_PAINT_PROBE expands to nothing and no profiling code is compiled.
+ */
+#ifndef GRIS_PAINT_INSTRUMENTATION
+ #define GRIS_PAINT_INSTRUMENTATION 0
+#endif
+
+#if GRIS_PAINT_INSTRUMENTATION
+
+#include <cstring>
+#include <map>
+#include <utility>
+
+//==============================================================================
+/** What has been measured for one draw override painting components of one name.
+
+ Total time includes the overrides called from this one, e.g. drawTickBox inside
+ drawToggleButton; self time leaves them out, so self times add up to the time
+ actually spent.
+ */
+struct GrisPaintProfile {
+    enum { numHistogramBuckets = 16 };
+
+    String overrideName;
+    String componentName;
+    int64 numCalls = 0;
+    int64 totalTicks = 0;
+    int64 selfTicks = 0;
+    int64 pixelArea = 0;
+
+    /** Bucket i counts the calls that took less than 2^i microseconds in total; the last one counts the rest. */
+    int64 histogram[numHistogramBuckets] = {};
+
+    double getTotalMilliseconds() const { return Time::highResolutionTicksToSeconds (this->totalTicks) * 1000.0; }
+    double getSelfMilliseconds() const  { return Time::highResolutionTicksToSeconds (this->selfTicks) * 1000.0; }
+    double getMeanMicroseconds() const  { return this->numCalls > 0 ? getTotalMilliseconds() * 1000.0 / this->numCalls : 0.0; }
+};
+
+//==============================================================================
+/** Process-wide store of every GrisPaintProfile, filled by GRIS_PAINT_PROBE.
+
+ Profiles are keyed by override and component name, not by component address, so
+ a component created where a deleted one was does not inherit its figures, and the
+ store only grows with the number of distinct names. Components that share a name,
+ or have none, are profiled together: name the widgets to tell them apart.
+ */
+class GrisPaintInstrumentation {
+public:
+    static void record (const char* overrideName, const Component* component, int64 ticks, int64 selfTicks, int64 pixelArea){
+        const String componentName (component != nullptr ? component->getName() : String());
+        GrisPaintInstrumentation& p = getInstance();
+        const SpinLock::ScopedLockType sl (p.lock);
+        GrisPaintProfile& profile = p.profiles[Key (overrideName, componentName)];
+
+        if (profile.numCalls == 0){
+            profile.overrideName = overrideName;
+            profile.componentName = componentName;
+        }
+
+        const double microseconds = Time::highResolutionTicksToSeconds (ticks) * 1.0e6;
+        int bucket = 0;
+        while (bucket < GrisPaintProfile::numHistogramBuckets - 1 && microseconds >= (double) (1 << bucket))
+            ++bucket;
+
+        ++profile.numCalls;
+        ++profile.histogram[bucket];
+        profile.totalTicks += ticks;
+        profile.selfTicks += selfTicks;
+        profile.pixelArea += pixelArea;
+    }
+
+    /** A copy of every profile, sorted by self time, most expensive first. */
+    static Array<GrisPaintProfile> getSnapshot(){
+        Array<GrisPaintProfile> snapshot;
+        GrisPaintInstrumentation& p = getInstance();
+
+        {
+            const SpinLock::ScopedLockType sl (p.lock);
+            for (auto it = p.profiles.begin(); it != p.profiles.end(); ++it)
+                snapshot.add (it->second);
+        }
+
+        struct BySelfTime {
+            static int compareElements (const GrisPaintProfile& a, const GrisPaintProfile& b){
+                return a.selfTicks > b.selfTicks ? -1 : (a.selfTicks < b.selfTicks ? 1 : 0);
+            }
+        } comparator;
+        snapshot.sort (comparator, true);
+        return snapshot;
+    }
+
+    static void reset(){
+        GrisPaintInstrumentation& p = getInstance();
+        const SpinLock::ScopedLockType sl (p.lock);
+        p.profiles.clear();
+    }
+
+private:
+    static GrisPaintInstrumentation& getInstance(){
+        static GrisPaintInstrumentation instance;
+        return instance;
+    }
+
+    typedef std::pair<const char*, String> Key;
+
+    /** Override names are compared by content: the same literal may have several addresses. */
+    struct KeyOrder {
+        bool operator() (const Key& a, const Key& b) const{
+            const int c = std::strcmp (a.first, b.first);
+            return c != 0 ? c < 0 : a.second < b.second;
+        }
+    };
+
+    SpinLock lock;
+    std::map<Key, GrisPaintProfile, KeyOrder> profiles;
+};
+
+//==============================================================================
+/** Times one draw override. Probes nest per thread: an inner probe's time is taken
+    out of the self time of the probe around it.
+ */
+struct GrisPaintProbe {
+    GrisPaintProbe (const char* name, Graphics& g, const Component* c)
+        : overrideName (name), component (c), parent (getCurrent()), childTicks (0),
+          start (Time::getHighResolutionTicks())
+    {
+        getCurrent() = this;
+
+        Rectangle<int> area (g.getClipBounds());
+        if (c != nullptr)
+            area = area.getIntersection (c->getLocalBounds());
+
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        this->pixelArea = (int64) (area.getWidth() * (double) area.getHeight() * scale * scale);
+    }
+
+    ~GrisPaintProbe(){
+        const int64 ticks = Time::getHighResolutionTicks() - this->start;
+        getCurrent() = this->parent;
+
+        if (this->parent != nullptr)
+            this->parent->childTicks += ticks;
+
+        GrisPaintInstrumentation::record (this->overrideName, this->component, ticks, ticks - this->childTicks, this->pixelArea);
+    }
+
+    static GrisPaintProbe*& getCurrent(){
+        static thread_local GrisPaintProbe* current = nullptr;
+        return current;
+    }
+
+    const char* overrideName;
+    const Component* component;
+    GrisPaintProbe* const parent;
+    int64 childTicks;
+    const int64 start;
+    int64 pixelArea;
+};
+
+ #define GRIS_PAINT_PROBE(overrideName, g, component) \
+    const GrisPaintProbe grisPaintProbe (overrideName, g, component)
+
+//==============================================================================
+/** Shows the most expensive override/component pairs, refreshed twice a second.
+
+ Add it on top of an editor while profiling; click it to reset the figures.
+ */
+class GrisPaintProfilerOverlay : public Component, private Timer {
+public:
+    explicit GrisPaintProfilerOverlay (int numRowsToShow = 12) : numRows (numRowsToShow){
+        setOpaque (true);
+        setInterceptsMouseClicks (true, false);
+        startTimer (500);
+    }
+
+    void paint (Graphics& g) override{
+        g.fillAll (Colours::black);
+        g.setColour (Colours::white);
+        g.setFont (Font (Font::getDefaultMonospacedFontName(), 11.0f, Font::plain));
+
+        const int rowHeight = 14;
+        int y = 2;
+        g.drawText ("override / component          calls     self ms    total ms   mean us        px", 4, y, getWidth() - 8, rowHeight, Justification::left, false);
+
+        for (int i = 0; i < this->rows.size() && i < this->numRows; ++i){
+            const GrisPaintProfile& p = this->rows.getReference (i);
+            y += rowHeight;
+
+            String name (p.overrideName);
+            if (p.componentName.isNotEmpty())
+                name << " / " << p.componentName;
+
+            String line (name.substring (0, 28).paddedRight (' ', 28));
+            line << String (p.numCalls).paddedLeft (' ', 8)
+                 << String (p.getSelfMilliseconds(), 1).paddedLeft (' ', 12)
+                 << String (p.getTotalMilliseconds(), 1).paddedLeft (' ', 12)
+                 << String (p.getMeanMicroseconds(), 1).paddedLeft (' ', 10)
+                 << String (p.pixelArea).paddedLeft (' ', 10);
+            g.drawText (line, 4, y, getWidth() - 8, rowHeight, Justification::left, false);
+        }
+    }
+
+    void mouseDown (const MouseEvent&) override{
+        GrisPaintInstrumentation::reset();
+        timerCallback();
+    }
+
+private:
+    void timerCallback() override{
+        this->rows = GrisPaintInstrumentation::getSnapshot();
+        repaint();
+    }
+
+    const int numRows;
+    Array<GrisPaintProfile> rows;
+};
+
+#else
+
+ #define GRIS_PAINT_PROBE(overrideName, g, component)
+
+#endif
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ ==============================================================================
+
+ GrisRepaintScheduler.h
+
+ One clock for the animated views of every GRIS editor of a process, so that
+ their repaints are coalesced into a single pass per frame.
+
+ ==============================================================================
+ */
+
+#ifndef GRISREPAINTSCHEDULER_H_INCLUDED
+#define GRISREPAINTSCHEDULER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include <atomic>
+
+#if JUCE_MAJOR_VERSION > 6 || (JUCE_MAJOR_VERSION == 6 && JUCE_MINOR_VERSION >= 1)
+ #define GRIS_REPAINT_SCHEDULER_HAS_VBLANK 1
+#else
+ #define GRIS_REPAINT_SCHEDULER_HAS_VBLANK 0
+#endif
+
+//==============================================================================
+/** Repaints the registered widgets that were marked dirty, once per frame.
+
+ Widgets derive from GrisRepaintScheduler::Client and call markDirty() from any
+ thread, including the audio thread, instead of calling repaint() from timers of
+ their own: marking is a pair of atomic stores. On each tick the scheduler visits
+ the dirty clients on the message thread and calls their handleRepaint(), which
+ repaints the whole component unless it is overridden to repaint less.
+
+ The scheduler is shared by every instance of a process through the
+ SharedResourcePointer each Client holds, and ticks at 30 Hz unless changed with
+ setFrameRate(). With JUCE 6.1 or later, attachToVBlank() ticks at the refresh
+ rate of the display showing a component instead, while that component is on
+ screen. When it is not, or once it is deleted, the scheduler ticks from its timer
+ again, so that the views of the other editors keep ticking.
+
+ @code
+ class TrajectoryView : public Component, public GrisRepaintScheduler::Client {
+ public:
+     TrajectoryView() : GrisRepaintScheduler::Client (static_cast<Component&> (*this)) {}
+     ...
+ };
+ @endcode
+
+ List Component before Client among the bases, so that the client is unregistered
+ before the component is destroyed.
+ */
+class GrisRepaintScheduler : private Timer, private ComponentListener {
+public:
+    class Client {
+    public:
+        explicit Client (Component& componentToRepaint)
+            : component (componentToRepaint), dirty (false), polling (false)
+        {
+            this->scheduler->addClient (this);
+        }
+
+        virtual ~Client(){
+            setPolling (false);
+            this->scheduler->removeClient (this);
+        }
+
+        /** Message thread: a polling client gets handleRepaint() on every tick, for views
+            that read shared state themselves instead of being marked dirty.
+         */
+        void setPolling (bool shouldPoll){
+            if (shouldPoll != this->polling){
+                this->polling = shouldPoll;
+                this->scheduler->numPollingClients += shouldPoll ? 1 : -1;
+            }
+        }
+
+        /** Asks for a repaint on the next tick. Lock-free and safe from any thread. */
+        void markDirty() noexcept{
+            if (this->dirty.exchange (true, std::memory_order_acq_rel))
+                this->scheduler->numCoalesced.fetch_add (1, std::memory_order_relaxed);
+            else
+                this->scheduler->anyDirty.store (true, std::memory_order_release);
+        }
+
+        GrisRepaintScheduler& getScheduler() noexcept   { return *this->scheduler; }
+
+    protected:
+        /** Called on the message thread at the first tick after markDirty(), or on every tick when polling. */
+        virtual void handleRepaint(){
+            this->component.repaint();
+        }
+
+        Component& component;
+
+    private:
+        friend class GrisRepaintScheduler;
+        SharedResourcePointer<GrisRepaintScheduler> scheduler;
+        std::atomic<bool> dirty;
+        bool polling;
+
+        JUCE_DECLARE_NON_COPYABLE (Client)
+    };
+
+    struct Stats {
+        int64 numTicks;
+        int64 numRepaints;
+
+        /** markDirty() calls that found the client already dirty, i.e. repaints saved. */
+        int64 numCoalesced;
+
+        /** Frames that were due but missed because the message thread was late. */
+        int64 numDropped;
+    };
+
+    GrisRepaintScheduler()
+        : anyDirty (false), numCoalesced (0),
+          numTicks (0), numRepaints (0), numDropped (0),
+          frameRate (30), lastTickTicks (0), numPollingClients (0)
+    {
+    }
+
+    ~GrisRepaintScheduler(){
+        jassert (this->clients.isEmpty());
+
+       #if GRIS_REPAINT_SCHEDULER_HAS_VBLANK
+        detachFromVBlank();
+       #endif
+    }
+
+    /** Message thread: frames per second of the timer mode. */
+    void setFrameRate (int framesPerSecond){
+        this->frameRate = jlimit (1, 240, framesPerSecond);
+
+        if (isTimerRunning())
+            startTimerHz (this->frameRate);
+    }
+
+    int getFrameRate() const noexcept   { return this->frameRate; }
+
+   #if GRIS_REPAINT_SCHEDULER_HAS_VBLANK
+    /** Message thread: ticks on the vertical blank of the display showing a component,
+        e.g. the editor, or goes back to the timer when passed nullptr. The timer also
+        ticks while the component is off screen, and takes over for good once it is deleted.
+     */
+    void attachToVBlank (Component* componentOnDisplay){
+        detachFromVBlank();
+
+        if (componentOnDisplay != nullptr){
+            this->vblankComponent = componentOnDisplay;
+            componentOnDisplay->addComponentListener (this);
+            this->vblank.reset (new VBlankAttachment (componentOnDisplay, [this]{ tick(); }));
+            updateTimer();
+        }
+    }
+
+    bool isAttachedToVBlank() const noexcept    { return this->vblank != nullptr; }
+   #endif
+
+    Stats getStats() const noexcept{
+        Stats s;
+        s.numTicks = this->numTicks;
+        s.numRepaints = this->numRepaints;
+        s.numCoalesced = this->numCoalesced.load (std::memory_order_relaxed);
+        s.numDropped = this->numDropped;
+        return s;
+    }
+
+    void resetStats() noexcept{
+        this->numTicks = this->numRepaints = this->numDropped = 0;
+        this->numCoalesced.store (0, std::memory_order_relaxed);
+    }
+
+    int getNumClients() const noexcept  { return this->clients.size(); }
+
+    /** Message thread: ticks now instead of waiting for the next frame, e.g. before
+        taking a snapshot of the editor. Counts as a tick in the stats.
+     */
+    void flush(){
+        tick();
+    }
+
+private:
+    void addClient (Client* c){
+        JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+        this->clients.add (c);
+        updateTimer();
+    }
+
+    void removeClient (Client* c){
+        JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+        this->clients.removeFirstMatchingValue (c);
+        updateTimer();
+    }
+
+    /** The timer runs while there are clients and no vertical blank to tick them. */
+    void updateTimer(){
+        if (this->clients.isEmpty() || isVBlankAttached())
+            stopTimer();
+        else if (! isTimerRunning())
+            startTimerHz (this->frameRate);
+    }
+
+   #if GRIS_REPAINT_SCHEDULER_HAS_VBLANK
+    void detachFromVBlank(){
+        this->vblank.reset();
+
+        if (this->vblankComponent != nullptr){
+            this->vblankComponent->removeComponentListener (this);
+            this->vblankComponent = nullptr;
+        }
+
+        updateTimer();
+    }
+
+    // the attachment only calls back while its component is on a desktop window
+    void componentBeingDeleted (Component&) override{
+        detachFromVBlank();
+    }
+
+    void componentParentHierarchyChanged (Component&) override{
+        updateTimer();
+    }
+   #endif
+
+    /** True when the vertical blank is actually ticking the clients. */
+    bool isVBlankAttached() const noexcept{
+       #if GRIS_REPAINT_SCHEDULER_HAS_VBLANK
+        return this->vblank != nullptr && this->vblankComponent->getPeer() != nullptr;
+       #else
+        return false;
+       #endif
+    }
+
+    void timerCallback() override{
+        tick();
+    }
+
+    void tick(){
+        const int64 now = Time::getHighResolutionTicks();
+
+        if (this->lastTickTicks != 0 && ! isVBlankAttached()){
+            const double frames = Time::highResolutionTicksToSeconds (now - this->lastTickTicks) * this->frameRate;
+            if (frames >= 2.0)
+                this->numDropped += (int64) frames - 1;
+        }
+
+        this->lastTickTicks = now;
+        ++this->numTicks;
+
+        if (! this->anyDirty.exchange (false, std::memory_order_acq_rel) && this->numPollingClients == 0)
+            return;
+
+        for (int i = 0; i < this->clients.size(); ++i){
+            Client* c = this->clients.getUnchecked (i);
+
+            if (c->dirty.exchange (false, std::memory_order_acq_rel) || c->polling){
+                c->handleRepaint();
+                ++this->numRepaints;
+            }
+        }
+    }
+
+    Array<Client*> clients;
+    std::atomic<bool> anyDirty;
+    std::atomic<int64> numCoalesced;
+    int64 numTicks, numRepaints, numDropped;
+    int frameRate;
+    int64 lastTickTicks;
+    int numPollingClients;
+
+   #if GRIS_REPAINT_SCHEDULER_HAS_VBLANK
+    std::unique_ptr<VBlankAttachment> vblank;
+    Component* vblankComponent = nullptr;
+   #endif
+
+    JUCE_DECLARE_NON_COPYABLE (GrisRepaintScheduler)
+};
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ ==============================================================================
+
+ GrisSignalDisplay.h
+
+ Scrolling waveform and spectrum views for input monitoring, fed from the
+ audio thread and drawn as one-pixel rectangle spans.
+
+ ==============================================================================
+ */
+
+#ifndef GRISSIGNALDISPLAY_H_INCLUDED
+#define GRISSIGNALDISPLAY_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+#include "GrisRepaintScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/** Shows the last seconds of several channels as a waveform, or their latest
+ magnitude spectra.
+
+ The audio thread copies its blocks into a lock-free FIFO with pushBlock(). On
+ each tick of the shared GrisRepaintScheduler the display drains it and reduces
+ the samples of each pixel column to a minimum, a maximum and an RMS, using
+ FloatVectorOperations over runs of samples rather than one sample at a time.
+ Painting draws one filled rectangle per column and per lane, without building
+ any Path: min/max spans in the on colour of the look and feel, RMS spans in its
+ light colour, spectrum bars in its green colour.
+
+ The display does not compute spectra. In spectrum mode, the processor passes the
+ magnitudes of its own FFT frames to setSpectrum(), from any thread, and the
+ display maps the bins onto a logarithmic frequency axis.
+ */
+class GrisSignalDisplay : public Component, public GrisRepaintScheduler::Client {
+public:
+    enum Mode { waveform = 0, spectrum };
+
+    GrisSignalDisplay (GrisLookAndFeel& lookAndFeel, int numChannelsToShow, int numSpectrumBinsToUse = 512,
+                       int fifoSamplesPerChannel = 32768)
+        : GrisRepaintScheduler::Client (static_cast<Component&> (*this)),
+          lnf (lookAndFeel), numChannels (jmax (1, numChannelsToShow)),
+          fifo (fifoSamplesPerChannel), fifoBuffer (numChannels, fifoSamplesPerChannel),
+          numBins (jmax (2, numSpectrumBinsToUse)),
+          magnitudes ((size_t) (numChannels * numBins)),
+          spectrumChanged (false), numDroppedSamples (0),
+          mode (waveform), timeSpan (2.0), sampleRate (48000.0), minimumDecibels (-90.0f),
+          samplesPerColumn (1), numColumns (0), writeColumn (0), pendingCount (0),
+          scratch ((size_t) 256), partialMin ((size_t) numChannels), partialMax ((size_t) numChannels),
+          partialSumSquares ((size_t) numChannels)
+    {
+        for (size_t i = 0; i < this->magnitudes.size(); ++i)
+            this->magnitudes[i].store (0.0f, std::memory_order_relaxed);
+
+        setOpaque (true);
+        setPolling (true);
+        resetPartial();
+    }
+
+    int getNumChannels() const noexcept { return this->numChannels; }
+
+    //==============================================================================
+    /** Audio thread: appends a block of every channel. Samples that do not fit in the
+        FIFO, e.g. while the editor is closed, are dropped and counted.
+     */
+    void pushBlock (const float* const* channelData, int numSamples) noexcept{
+        int start1, size1, start2, size2;
+        this->fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+        for (int ch = 0; ch < this->numChannels; ++ch){
+            if (size1 > 0)
+                FloatVectorOperations::copy (this->fifoBuffer.getWritePointer (ch, start1), channelData[ch], size1);
+            if (size2 > 0)
+                FloatVectorOperations::copy (this->fifoBuffer.getWritePointer (ch, start2), channelData[ch] + size1, size2);
+        }
+
+        this->fifo.finishedWrite (size1 + size2);
+
+        if (size1 + size2 < numSamples)
+            this->numDroppedSamples += numSamples - size1 - size2;
+    }
+
+    /** Any thread: the linear magnitudes of the latest spectrum of a channel, numBins
+        values from DC to Nyquist.
+     */
+    void setSpectrum (int channel, const float* binMagnitudes) noexcept{
+        jassert (isPositiveAndBelow (channel, this->numChannels));
+        std::atomic<float>* dest = &this->magnitudes[(size_t) (channel * this->numBins)];
+
+        for (int i = 0; i < this->numBins; ++i)
+            dest[i].store (binMagnitudes[i], std::memory_order_relaxed);
+
+        this->spectrumChanged.store (true, std::memory_order_release);
+    }
+
+    int64 getNumDroppedSamples() const noexcept { return this->numDroppedSamples.get(); }
+
+    //==============================================================================
+    void setMode (Mode newMode){
+        this->mode = newMode;
+        repaint();
+    }
+
+    /** Seconds shown across the width of the waveform, at the stream's sample rate. */
+    void setTimeSpan (double seconds, double newSampleRate){
+        this->timeSpan = seconds;
+        this->sampleRate = newSampleRate;
+        resized();
+    }
+
+    void setMinimumDecibels (float db)  { this->minimumDecibels = db; repaint(); }
+
+    /** Message thread: reduces the samples waiting in the FIFO to columns. Called on each
+        scheduler tick; returns the number of samples consumed.
+     */
+    int consume(){
+        int start1, size1, start2, size2;
+        this->fifo.prepareToRead (this->fifo.getNumReady(), start1, size1, start2, size2);
+
+        reduce (start1, size1);
+        reduce (start2, size2);
+
+        this->fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    /** The reduction of the samples of one pixel column. */
+    struct Column {
+        float min, max, rms;
+    };
+
+    /** Message thread: column x of a channel as the waveform shows it, 0 being the oldest. */
+    Column getColumn (int channel, int x) const noexcept{
+        jassert (isPositiveAndBelow (channel, this->numChannels) && isPositiveAndBelow (x, this->numColumns));
+        const size_t index = (size_t) (channel * this->numColumns + (this->writeColumn + x) % this->numColumns);
+
+        Column c;
+        c.min = this->columnMin[index];
+        c.max = this->columnMax[index];
+        c.rms = this->columnRms[index];
+        return c;
+    }
+
+    int getSamplesPerColumn() const noexcept    { return this->samplesPerColumn; }
+
+    //==============================================================================
+    void paint (Graphics& g) override{
+        const GrisTheme& t = this->lnf.getTheme();
+        g.fillAll (t.winBackground);
+
+        if (this->numColumns == 0)
+            return;
+
+        const Rectangle<int> clip (g.getClipBounds());
+        const int firstColumn = jmax (0, clip.getX());
+        const int lastColumn = jmin (this->numColumns, clip.getRight());
+        const int laneHeight = getHeight() / this->numChannels;
+
+        for (int ch = 0; ch < this->numChannels; ++ch){
+            const Rectangle<int> lane (0, ch * laneHeight, getWidth(), laneHeight - 1);
+
+            if (! clip.intersects (lane))
+                continue;
+
+            if (this->mode == waveform)
+                paintWaveform (g, t, ch, lane, firstColumn, lastColumn);
+            else
+                paintSpectrum (g, t, ch, lane, firstColumn, lastColumn);
+        }
+    }
+
+    void resized() override{
+        this->numColumns = jmax (0, getWidth());
+        this->columnMin.assign ((size_t) (this->numColumns * this->numChannels), 0.0f);
+        this->columnMax.assign ((size_t) (this->numColumns * this->numChannels), 0.0f);
+        this->columnRms.assign ((size_t) (this->numColumns * this->numChannels), 0.0f);
+        this->writeColumn = 0;
+        this->samplesPerColumn = jmax (1, roundToInt (this->timeSpan * this->sampleRate / jmax (1, this->numColumns)));
+        resetPartial();
+
+        // first bin shown by each column, log spaced from bin 1 to Nyquist, plus an end marker
+        this->columnBins.resize ((size_t) this->numColumns + 1);
+        for (int x = 0; x <= this->numColumns; ++x){
+            const double proportion = x / (double) jmax (1, this->numColumns);
+            this->columnBins[(size_t) x] = jlimit (1, this->numBins, (int) std::pow ((double) this->numBins, proportion));
+        }
+
+        repaint();
+    }
+
+private:
+    void handleRepaint() override{
+        const bool newSpectrum = this->spectrumChanged.exchange (false, std::memory_order_acq_rel);
+        const bool newSamples = consume() > 0;
+
+        if ((newSamples && this->mode == waveform) || (newSpectrum && this->mode == spectrum))
+            repaint();
+    }
+
+    void resetPartial(){
+        this->pendingCount = 0;
+        std::fill (this->partialMin.begin(), this->partialMin.end(), 0.0f);
+        std::fill (this->partialMax.begin(), this->partialMax.end(), 0.0f);
+        std::fill (this->partialSumSquares.begin(), this->partialSumSquares.end(), 0.0f);
+    }
+
+    /** Folds samples [start, start + num) of the FIFO into the columns, a run at a time. */
+    void reduce (int start, int num){
+        if (this->numColumns == 0)
+            return;
+
+        int offset = 0;
+
+        while (offset < num){
+            const int run = jmin (num - offset, this->samplesPerColumn - this->pendingCount, (int) this->scratch.size());
+
+            for (int ch = 0; ch < this->numChannels; ++ch){
+                const float* samples = this->fifoBuffer.getReadPointer (ch, start + offset);
+                const Range<float> r (FloatVectorOperations::findMinAndMax (samples, run));
+                FloatVectorOperations::multiply (this->scratch.data(), samples, samples, run);
+
+                float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+                int i = 0;
+                for (; i + 4 <= run; i += 4){
+                    sum0 += this->scratch[(size_t) i];
+                    sum1 += this->scratch[(size_t) i + 1];
+                    sum2 += this->scratch[(size_t) i + 2];
+                    sum3 += this->scratch[(size_t) i + 3];
+                }
+                for (; i < run; ++i)
+                    sum0 += this->scratch[(size_t) i];
+
+                const size_t c = (size_t) ch;
+                this->partialMin[c] = this->pendingCount == 0 ? r.getStart() : jmin (this->partialMin[c], r.getStart());
+                this->partialMax[c] = this->pendingCount == 0 ? r.getEnd() : jmax (this->partialMax[c], r.getEnd());
+                this->partialSumSquares[c] += (sum0 + sum1) + (sum2 + sum3);
+            }
+
+            this->pendingCount += run;
+            offset += run;
+
+            if (this->pendingCount == this->samplesPerColumn){
+                for (int ch = 0; ch < this->numChannels; ++ch){
+                    const size_t index = (size_t) (ch * this->numColumns + this->writeColumn);
+                    this->columnMin[index] = this->partialMin[(size_t) ch];
+                    this->columnMax[index] = this->partialMax[(size_t) ch];
+                    this->columnRms[index] = std::sqrt (this->partialSumSquares[(size_t) ch] / this->samplesPerColumn);
+                }
+
+                this->writeColumn = (this->writeColumn + 1) % this->numColumns;
+                resetPartial();
+            }
+        }
+    }
+
+    void paintWaveform (Graphics& g, const GrisTheme& t, int ch, const Rectangle<int>& lane, int firstColumn, int lastColumn){
+        const float mid = (float) lane.getCentreY();
+        const float half = lane.getHeight() * 0.5f;
+        const float* mins = &this->columnMin[(size_t) (ch * this->numColumns)];
+        const float* maxs = &this->columnMax[(size_t) (ch * this->numColumns)];
+        const float* rms = &this->columnRms[(size_t) (ch * this->numColumns)];
+
+        // the column written next is the oldest one, drawn on the left
+        g.setColour (t.on);
+        for (int x = firstColumn; x < lastColumn; ++x){
+            const int c = (this->writeColumn + x) % this->numColumns;
+            const int top = roundToInt (mid - jlimit (-1.0f, 1.0f, maxs[c]) * half);
+            const int bottom = roundToInt (mid - jlimit (-1.0f, 1.0f, mins[c]) * half);
+            g.fillRect (x, top, 1, jmax (1, bottom - top));
+        }
+
+        g.setColour (t.light);
+        for (int x = firstColumn; x < lastColumn; ++x){
+            const int c = (this->writeColumn + x) % this->numColumns;
+            const int extent = roundToInt (jmin (1.0f, rms[c]) * half);
+
+            if (extent > 0)
+                g.fillRect (x, roundToInt (mid) - extent, 1, 2 * extent);
+        }
+    }
+
+    void paintSpectrum (Graphics& g, const GrisTheme& t, int ch, const Rectangle<int>& lane, int firstColumn, int lastColumn){
+        const std::atomic<float>* bins = &this->magnitudes[(size_t) (ch * this->numBins)];
+        g.setColour (t.green);
+
+        for (int x = firstColumn; x < lastColumn; ++x){
+            float peak = 0.0f;
+            const int end = jmax (this->columnBins[(size_t) x] + 1, this->columnBins[(size_t) x + 1]);
+
+            for (int b = this->columnBins[(size_t) x]; b < end && b < this->numBins; ++b)
+                peak = jmax (peak, bins[b].load (std::memory_order_relaxed));
+
+            const float db = Decibels::gainToDecibels (peak, this->minimumDecibels);
+            const int barHeight = roundToInt ((db - this->minimumDecibels) / -this->minimumDecibels * lane.getHeight());
+
+            if (barHeight > 0)
+                g.fillRect (x, lane.getBottom() - barHeight, 1, barHeight);
+        }
+    }
+
+    GrisLookAndFeel& lnf;
+    const int numChannels;
+
+    AbstractFifo fifo;
+    AudioSampleBuffer fifoBuffer;
+    const int numBins;
+    std::vector<std::atomic<float>> magnitudes;
+    std::atomic<bool> spectrumChanged;
+    Atomic<int64> numDroppedSamples;
+
+    Mode mode;
+    double timeSpan, sampleRate;
+    float minimumDecibels;
+
+    int samplesPerColumn, numColumns, writeColumn, pendingCount;
+    std::vector<float> scratch, partialMin, partialMax, partialSumSquares;
+    std::vector<float> columnMin, columnMax, columnRms;
+    std::vector<int> columnBins;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisSignalDisplay)
+};
+
+#endif
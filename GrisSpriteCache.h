@@ -0,0 +1,153 @@
+/*
+ ==============================================================================
+
+ GrisSpriteCache.h
+
+ Small image cache used by the GRIS look and feel to keep pre-rendered
+ widget sprites (knob frames, shadows, ...) between paints.
+
+ ==============================================================================
+ */
+
+#ifndef GRISSPRITECACHE_H_INCLUDED
+#define GRISSPRITECACHE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include <list>
+#include <unordered_map>
+
+//==============================================================================
+/** Builds a 64 bit key out of the inputs that define a sprite.
+
+ Floats are quantised to 1/256 so that tiny layout jitter does not produce
+ distinct entries.
+ */
+class GrisSpriteKey {
+public:
+    explicit GrisSpriteKey (int kind) : hash (14695981039346656037ULL) { add (kind); }
+
+    GrisSpriteKey& add (int64 value){
+        for (int i = 0; i < 8; ++i){
+            this->hash ^= (uint64) ((value >> (i * 8)) & 0xff);
+            this->hash *= 1099511628211ULL;
+        }
+        return *this;
+    }
+    GrisSpriteKey& add (int value)          { return add ((int64) value); }
+    GrisSpriteKey& add (bool value)         { return add ((int64) (value ? 1 : 0)); }
+    GrisSpriteKey& add (float value)        { return add ((int64) roundToInt (value * 256.0f)); }
+    GrisSpriteKey& add (const Colour& c)    { return add ((int64) c.getARGB()); }
+    GrisSpriteKey& add (const String& s)    { return add ((int64) s.hashCode64()); }
+
+    uint64 get() const { return this->hash; }
+
+private:
+    uint64 hash;
+};
+
+//==============================================================================
+/** Least-recently-used store of sprites, bounded by the number of pixel bytes it holds.
+
+ Images are reference counted, so handing one out never copies pixels. All methods
+ are thread safe.
+ */
+class GrisSpriteCache {
+public:
+    explicit GrisSpriteCache (size_t maxBytesToUse = 8 * 1024 * 1024)
+        : maxBytes (maxBytesToUse), numBytes (0) {}
+
+    /** Returns the sprite stored for this key, or a null Image. */
+    Image get (uint64 key){
+        const ScopedLock sl (this->lock);
+        auto found = this->entries.find (key);
+
+        if (found == this->entries.end()){
+            ++this->misses;
+            return Image();
+        }
+
+        ++this->hits;
+        this->order.splice (this->order.begin(), this->order, found->second);
+        return found->second->image;
+    }
+
+    void put (uint64 key, const Image& image){
+        const ScopedLock sl (this->lock);
+        auto found = this->entries.find (key);
+
+        if (found != this->entries.end()){
+            this->numBytes -= found->second->numBytes;
+            this->order.erase (found->second);
+            this->entries.erase (found);
+        }
+
+        Entry e;
+        e.key = key;
+        e.image = image;
+        e.numBytes = image.isValid() ? (size_t) (image.getWidth() * image.getHeight() * 4) : 0;
+
+        this->order.push_front (e);
+        this->entries[key] = this->order.begin();
+        this->numBytes += e.numBytes;
+
+        trim();
+    }
+
+    void clear(){
+        const ScopedLock sl (this->lock);
+        this->order.clear();
+        this->entries.clear();
+        this->numBytes = 0;
+    }
+
+    void setMaxBytes (size_t newMaxBytes){
+        const ScopedLock sl (this->lock);
+        this->maxBytes = newMaxBytes;
+        trim();
+    }
+
+    size_t getMaxBytes() const      { return this->maxBytes; }
+    size_t getNumBytes() const      { const ScopedLock sl (this->lock); return this->numBytes; }
+    int    getNumSprites() const    { const ScopedLock sl (this->lock); return (int) this->entries.size(); }
+    int    getNumHits() const       { return this->hits.get(); }
+    int    getNumMisses() const     { return this->misses.get(); }
+
+    /** Share of the lookups answered from the cache since the last resetStats(), 0 to 1. */
+    float getHitRate() const{
+        const int numHits = this->hits.get();
+        const int numLookups = numHits + this->misses.get();
+        return numLookups > 0 ? (float) numHits / (float) numLookups : 0.0f;
+    }
+
+    void resetStats(){
+        this->hits = 0;
+        this->misses = 0;
+    }
+
+private:
+    struct Entry {
+        uint64 key;
+        Image  image;
+        size_t numBytes;
+    };
+
+    void trim(){
+        while (this->numBytes > this->maxBytes && this->order.size() > 1){
+            const Entry& last = this->order.back();
+            this->numBytes -= last.numBytes;
+            this->entries.erase (last.key);
+            this->order.pop_back();
+        }
+    }
+
+    CriticalSection lock;
+    std::list<Entry> order;
+    std::unordered_map<uint64, std::list<Entry>::iterator> entries;
+    size_t maxBytes, numBytes;
+    Atomic<int> hits, misses;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisSpriteCache)
+};
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ ==============================================================================
+
+ GrisSpriteWarmUp.h
+
+ Pre-renders the GrisLookAndFeel sprites an editor is about to need on the
+ shared worker threads, while the editor is being opened.
+
+ ==============================================================================
+ */
+
+#ifndef GRISSPRITEWARMUP_H_INCLUDED
+#define GRISSPRITEWARMUP_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+#include "GrisWorkerPool.h"
+
+//==============================================================================
+/** Fills the look and feel's sprite caches in the background.
+
+ Create one as a member of the editor, after setting up its widgets:
+
+ @code
+ GrisSpriteWarmUp::Sizes sizes;
+ sizes.scale = getDesktopScaleFactor();
+ sizes.comboBoxButtons.add (Rectangle<int> (0, 0, 22, 22));
+ sizes.roundThumbDiameters.add (16.0f);
+ sizes.roundThumbColours.add (lookAndFeel.getOnColour());
+ warmUp = new GrisSpriteWarmUp (lookAndFeel, sizes);
+ @endcode
+
+ Combo box arrows (enabled and disabled), round thumbs and, when the filmstrip is
+ on, the rotary frames of the normal, hover and disabled states are rendered into
+ the caches that the draw overrides read, so the first paint mostly composites
+ images. Tick boxes and linear slider thumbs are plain rectangle fills and need no
+ sprite.
+
+ Rotary frames stop at the byte budget of the filmstrip cache, normal state first:
+ rendering more would only evict the frames rendered before.
+
+ Deleting the warm-up, e.g. because the editor closed early, cancels the jobs
+ that have not finished.
+ */
+class GrisSpriteWarmUp {
+public:
+    struct Sizes {
+        float scale = 1.0f;
+
+        /** Only the width and height of these are used. */
+        Array<Rectangle<int>> comboBoxButtons;
+
+        Array<float> roundThumbDiameters;
+        Array<Colour> roundThumbColours;
+        float roundThumbOutline = 1.0f;
+
+        /** Only the width and height of these are used. */
+        Array<Rectangle<int>> rotarySliders;
+        float rotaryStartAngle = float_Pi * 1.2f;
+        float rotaryEndAngle = float_Pi * 2.8f;
+    };
+
+    GrisSpriteWarmUp (GrisLookAndFeel& lookAndFeel, const Sizes& sizesToRender)
+        : lnf (lookAndFeel), theme (lookAndFeel.getThemePtr()), sizes (sizesToRender),
+          rotaryFrames (lookAndFeel.isRotaryFilmstripEnabled() ? lookAndFeel.getRotaryFilmstripFrames() : 0)
+    {
+        this->jobs.add (new Job (*this, comboBoxes));
+        this->jobs.add (new Job (*this, roundThumbs));
+        this->jobs.add (new Job (*this, rotaryFilmstrip));
+
+        for (int i = 0; i < this->jobs.size(); ++i)
+            this->workers->getPool().addJob (this->jobs.getUnchecked (i), false);
+    }
+
+    ~GrisSpriteWarmUp(){
+        cancel();
+    }
+
+    /** Stops the jobs that are still queued or running and waits for them.
+
+        The wait has no timeout: the jobs read this object and are owned by it, so they
+        must be off the pool before it can go. A running job checks shouldExit() between
+        sprites, so this waits for one sprite at most.
+     */
+    void cancel(){
+        for (int i = 0; i < this->jobs.size(); ++i)
+            this->workers->getPool().removeJob (this->jobs.getUnchecked (i), true, -1);
+    }
+
+    bool isFinished() const{
+        for (int i = 0; i < this->jobs.size(); ++i)
+            if (this->workers->getPool().contains (this->jobs.getUnchecked (i)))
+                return false;
+        return true;
+    }
+
+    /** Rotary frames rendered so far, in the order normal, hover, disabled, then slider and frame. */
+    int getNumRotaryFramesWarmed() const noexcept   { return this->numRotaryFramesWarmed.get(); }
+
+private:
+    enum Kind { comboBoxes, roundThumbs, rotaryFilmstrip };
+
+    class Job : public ThreadPoolJob {
+    public:
+        Job (GrisSpriteWarmUp& ownerToUse, Kind kindToRender)
+            : ThreadPoolJob ("GRIS sprite warm-up"), owner (ownerToUse), kind (kindToRender) {}
+
+        JobStatus runJob() override{
+            GrisLookAndFeel& lnf = this->owner.lnf;
+            const GrisTheme& t = *this->owner.theme;
+            const Sizes& s = this->owner.sizes;
+
+            switch (this->kind){
+                case comboBoxes:
+                    for (int i = 0; i < s.comboBoxButtons.size() && ! shouldExit(); ++i){
+                        const Rectangle<int>& r = s.comboBoxButtons.getReference (i);
+                        lnf.getComboBoxArrowSprite (t, r.getWidth(), r.getHeight(), true, s.scale);
+                        lnf.getComboBoxArrowSprite (t, r.getWidth(), r.getHeight(), false, s.scale);
+                    }
+                    break;
+
+                case roundThumbs:
+                    for (int i = 0; i < s.roundThumbDiameters.size() && ! shouldExit(); ++i)
+                        for (int c = 0; c < s.roundThumbColours.size() && ! shouldExit(); ++c)
+                            lnf.getRoundThumbSprite (t, s.roundThumbDiameters[i], s.roundThumbColours[c],
+                                                     s.roundThumbOutline, s.scale);
+                    break;
+
+                case rotaryFilmstrip:
+                {
+                    const GrisTheme::State states[] = { GrisTheme::normal, GrisTheme::hover, GrisTheme::disabled };
+                    const int numFrames = this->owner.rotaryFrames;
+                    const size_t budget = lnf.getRotaryFilmstripCache().getMaxBytes();
+                    size_t numBytes = 0;
+
+                    for (int st = 0; st < numElementsInArray (states) && numFrames > 1; ++st)
+                        for (int i = 0; i < s.rotarySliders.size(); ++i){
+                            const Rectangle<int>& r = s.rotarySliders.getReference (i);
+                            const size_t spriteBytes = (size_t) jmax (1, roundToInt (r.getWidth() * s.scale))
+                                                        * (size_t) jmax (1, roundToInt (r.getHeight() * s.scale)) * 4;
+
+                            for (int frame = 0; frame < numFrames; ++frame){
+                                if (shouldExit() || numBytes + spriteBytes > budget)
+                                    return jobHasFinished;
+
+                                lnf.getRotaryFrameSprite (r.getWidth(), r.getHeight(), s.rotaryStartAngle, s.rotaryEndAngle,
+                                                          t.getColour (GrisTheme::rotarySlider, states[st]),
+                                                          frame, numFrames, s.scale);
+                                numBytes += spriteBytes;
+                                ++this->owner.numRotaryFramesWarmed;
+                            }
+                        }
+                    break;
+                }
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        GrisSpriteWarmUp& owner;
+        const Kind kind;
+    };
+
+    GrisLookAndFeel& lnf;
+    const GrisTheme::Ptr theme;
+    const Sizes sizes;
+    const int rotaryFrames;
+    Atomic<int> numRotaryFramesWarmed;
+    SharedResourcePointer<GrisWorkerPool> workers;
+    OwnedArray<Job> jobs;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisSpriteWarmUp)
+};
+
+#endif
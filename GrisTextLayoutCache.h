@@ -0,0 +1,188 @@
+/*
+ ==============================================================================
+
+ GrisTextLayoutCache.h
+
+ Keeps the glyph layouts of the short strings drawn by GrisLookAndFeel
+ (toggle numbers, tab names, ...) so they are not shaped again on every paint.
+
+ ==============================================================================
+ */
+
+#ifndef GRISTEXTLAYOUTCACHE_H_INCLUDED
+#define GRISTEXTLAYOUTCACHE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include <list>
+#include <unordered_map>
+
+//==============================================================================
+/** Bounded least-recently-used cache of laid-out text.
+
+ Entries are keyed by text, font, area, justification and colour. A fitted
+ string is stored as a GlyphArrangement and drawn with the Graphics' current
+ colour; an attributed string is stored as a TextLayout with its colour baked in.
+
+ Entries are immutable and reference counted: the lock is only held to look them
+ up, so threads draw cached text in parallel. The cache keeps defaultMaxEntries
+ strings unless told otherwise; a view drawing more distinct strings on every
+ paint than the limit gets no hits, so it should reserve() room for them.
+ */
+class GrisTextLayoutCache {
+public:
+    enum { defaultMaxEntries = 512 };
+
+    explicit GrisTextLayoutCache (int maxEntriesToKeep = defaultMaxEntries) : maxEntries (maxEntriesToKeep) {}
+
+    /** Same result as g.drawFittedText() with the given font. */
+    void drawFittedText (Graphics& g, const Font& font, const String& text, int x, int y, int width, int height,
+                         Justification justification, int maximumNumberOfLines, float minimumHorizontalScale = 0.7f)
+    {
+        if (text.isEmpty())
+            return;
+
+        const uint64 key = makeKey (fittedText, font, text, (float) x, (float) y, (float) width, (float) height,
+                                    justification, Colours::transparentBlack, maximumNumberOfLines, minimumHorizontalScale);
+        Entry::Ptr e (find (key, text));
+
+        if (e == nullptr){
+            e = new Entry (key, text);
+            e->glyphs.addFittedText (font, text, (float) x, (float) y, (float) width, (float) height,
+                                     justification, maximumNumberOfLines, minimumHorizontalScale);
+            add (e);
+        }
+
+        e->glyphs.draw (g);
+    }
+
+    /** Lays out text as a single AttributedString run of the given width and draws it in area. */
+    void drawText (Graphics& g, const Font& font, const String& text, Colour colour,
+                   Justification justification, float width, const Rectangle<float>& area)
+    {
+        const uint64 key = makeKey (attributedText, font, text, area.getX(), area.getY(), width, area.getHeight(),
+                                    justification, colour, 0, 0.0f);
+        Entry::Ptr e (find (key, text));
+
+        if (e == nullptr){
+            e = new Entry (key, text);
+
+            AttributedString s;
+            s.setJustification (justification);
+            s.append (text, font, colour);
+            e->layout.createLayout (s, width);
+            add (e);
+        }
+
+        e->layout.draw (g, area);
+    }
+
+    void clear(){
+        const ScopedLock sl (this->lock);
+        this->order.clear();
+        this->entries.clear();
+    }
+
+    void setMaxEntries (int newMaxEntries){
+        const ScopedLock sl (this->lock);
+        this->maxEntries = jmax (1, newMaxEntries);
+        trim();
+    }
+
+    /** Raises the limit, if needed, so that numEntriesNeeded strings fit on top of the default. */
+    void reserve (int numEntriesNeeded){
+        const ScopedLock sl (this->lock);
+        this->maxEntries = jmax (this->maxEntries, (int) defaultMaxEntries + numEntriesNeeded);
+    }
+
+    int getMaxEntries() const   { const ScopedLock sl (this->lock); return this->maxEntries; }
+
+    int getNumEntries() const   { const ScopedLock sl (this->lock); return (int) this->entries.size(); }
+    int getNumHits() const      { return this->hits.get(); }
+    int getNumMisses() const    { return this->misses.get(); }
+    void resetCounters()        { this->hits = 0; this->misses = 0; }
+
+private:
+    enum Kind { fittedText = 1, attributedText = 2 };
+
+    /** Filled in before add(), then only read. */
+    struct Entry : public ReferenceCountedObject {
+        typedef ReferenceCountedObjectPtr<Entry> Ptr;
+
+        Entry (uint64 k, const String& t) : key (k), text (t) {}
+
+        const uint64 key;
+        const String text;
+        GlyphArrangement glyphs;
+        TextLayout layout;
+    };
+
+    static uint64 makeKey (Kind kind, const Font& font, const String& text, float x, float y, float w, float h,
+                           Justification justification, Colour colour, int maxLines, float minScale)
+    {
+        uint64 hash = (uint64) text.hashCode64();
+        const int64 fields[] = { (int64) kind,
+                                 (int64) font.getTypefaceName().hashCode(),
+                                 (int64) font.getStyleFlags(),
+                                 (int64) roundToInt (font.getHeight() * 256.0f),
+                                 (int64) roundToInt (font.getHorizontalScale() * 256.0f),
+                                 (int64) roundToInt (x * 256.0f), (int64) roundToInt (y * 256.0f),
+                                 (int64) roundToInt (w * 256.0f), (int64) roundToInt (h * 256.0f),
+                                 (int64) justification.getFlags(),
+                                 (int64) colour.getARGB(),
+                                 (int64) maxLines,
+                                 (int64) roundToInt (minScale * 256.0f) };
+
+        for (int i = 0; i < numElementsInArray (fields); ++i)
+            hash = (hash ^ (uint64) fields[i]) * 1099511628211ULL;
+
+        return hash;
+    }
+
+    Entry::Ptr find (uint64 key, const String& text){
+        const ScopedLock sl (this->lock);
+        auto found = this->entries.find (key);
+
+        if (found == this->entries.end() || found->second->text != text){
+            ++this->misses;
+            return nullptr;
+        }
+
+        ++this->hits;
+        this->order.splice (this->order.begin(), this->order, found->second);
+        return *found->second;
+    }
+
+    /** Stores a new entry, replacing one another thread may have laid out meanwhile. */
+    void add (const Entry::Ptr& e){
+        const ScopedLock sl (this->lock);
+        auto found = this->entries.find (e->key);
+
+        if (found != this->entries.end()){
+            this->order.erase (found->second);
+            this->entries.erase (found);
+        }
+
+        this->order.push_front (e);
+        this->entries[e->key] = this->order.begin();
+
+        trim();
+    }
+
+    void trim(){
+        while ((int) this->order.size() > this->maxEntries && this->order.size() > 1){
+            this->entries.erase (this->order.back()->key);
+            this->order.pop_back();
+        }
+    }
+
+    CriticalSection lock;
+    std::list<Entry::Ptr> order;
+    std::unordered_map<uint64, std::list<Entry::Ptr>::iterator> entries;
+    int maxEntries;
+    Atomic<int> hits, misses;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisTextLayoutCache)
+};
+
+#endif
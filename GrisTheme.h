@@ -0,0 +1,176 @@
+/*
+ ==============================================================================
+
+ GrisTheme.h
+
+ The GRIS palette and every colour derived from it, computed once per theme
+ instead of on each paint.
+
+ ==============================================================================
+ */
+
+#ifndef GRISTHEME_H_INCLUDED
+#define GRISTHEME_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/** An immutable colour theme for GrisLookAndFeel.
+
+ The constructor resolves, for each widget kind, the colour of every
+ enabled/disabled/hover/down/toggled state, so that draw calls only index a table.
+ A GrisLookAndFeel switches theme with setTheme(), which swaps a pointer.
+ */
+class GrisTheme : public ReferenceCountedObject {
+public:
+    typedef ReferenceCountedObjectPtr<GrisTheme> Ptr;
+
+    /** Base colours of a theme, as 0xAARRGGBB. */
+    struct Palette {
+        uint32 background, winBackground;
+        uint32 light, dark, grey, editBackground;
+        uint32 on, onOver, onDown, off, green, red;
+    };
+
+    /** The SpatGRIS/ServerGRIS palette. */
+    static constexpr Palette getBuiltInPalette(){
+        return { 0xff4b4b4b, 0xff2e2e2e,
+                 0xffebf5fa, 0xff0f0a05, 0xff787878, 0xffacacac,
+                 0xffffa519, 0xffffb84b, 0xffde9016, 0xff383838, 0xff389c38, 0xffdc3023 };
+    }
+
+    enum Widget {
+        tickBox = 0,
+        buttonBackground,
+        comboBoxArrow,
+        linearSliderThumb,
+        rotarySlider,
+        numWidgets
+    };
+
+    enum State {
+        normal = 0,
+        hover,
+        down,
+        disabled,
+        toggled,
+        toggledHover,
+        toggledDisabled,
+        numStates
+    };
+
+    explicit GrisTheme (const Palette& p)
+        : palette (p),
+          background (p.background), winBackground (p.winBackground),
+          light (p.light), dark (p.dark), grey (p.grey), editBackground (p.editBackground),
+          on (p.on), onOver (p.onOver), onDown (p.onDown), off (p.off), green (p.green), red (p.red)
+    {
+        const Colour onDisabled (this->on.withBrightness (0.3f));
+        const Colour offDisabled (this->off.withBrightness (0.3f));
+
+        setStates (tickBox,           this->off, this->off, this->onDown, offDisabled,
+                                      this->on, this->onOver, onDisabled);
+        setStates (buttonBackground,  this->editBackground, this->onOver, this->onDown, this->editBackground,
+                                      this->on, this->on, this->on);
+        setStates (comboBoxArrow,     this->dark, this->dark, this->dark, this->dark.withMultipliedAlpha (0.3f),
+                                      this->dark, this->dark, this->dark.withMultipliedAlpha (0.3f));
+        setStates (linearSliderThumb, this->on, this->onOver, this->onDown, this->off,
+                                      this->on, this->onOver, this->off);
+        setStates (rotarySlider,      this->on, this->onOver, this->onOver, this->off,
+                                      this->on, this->onOver, this->off);
+
+        const Colour* const bases[] = { &this->background, &this->winBackground, &this->light, &this->dark,
+                                        &this->grey, &this->editBackground, &this->on, &this->onOver,
+                                        &this->onDown, &this->off, &this->green, &this->red };
+        static_assert (sizeof (bases) / sizeof (bases[0]) == numDerived, "every palette colour needs derived colours");
+
+        for (int i = 0; i < numDerived; ++i){
+            Derived& d = this->derived[i];
+            d.base = *bases[i];
+            d.brighter = d.base.brighter();
+            d.tabBackground = d.base.brighter (0.1f);
+            d.tabText[0] = d.base.contrasting().withMultipliedAlpha (1.0f);
+            d.tabText[1] = d.base.contrasting().withMultipliedAlpha (0.8f);
+            d.tabText[2] = d.base.contrasting().withMultipliedAlpha (0.3f);
+        }
+    }
+
+    /** The theme GrisLookAndFeel starts with, shared by every instance. */
+    static Ptr getBuiltIn(){
+        static Ptr builtIn (new GrisTheme (getBuiltInPalette()));
+        return builtIn;
+    }
+
+    static State getState (bool isEnabled, bool isToggled, bool isOver, bool isDown){
+        if (! isEnabled)    return isToggled ? toggledDisabled : disabled;
+        if (isDown)         return down;
+        if (isToggled)      return isOver ? toggledHover : toggled;
+        return isOver ? hover : normal;
+    }
+
+    const Colour& getColour (Widget widget, State state) const{
+        return this->table[widget][state];
+    }
+
+    /** colour.brighter(), looked up for palette colours. */
+    Colour getBrighter (const Colour& colour) const{
+        if (const Derived* d = findDerived (colour))
+            return d->brighter;
+        return colour.brighter();
+    }
+
+    /** Background of a tab that is not at the front, i.e. bkg.brighter (0.1f). */
+    Colour getTabBackground (const Colour& bkg) const{
+        if (const Derived* d = findDerived (bkg))
+            return d->tabBackground;
+        return bkg.brighter (0.1f);
+    }
+
+    /** Tab text drawn over bkg: highlighted when hovered or pressed, faded when disabled. */
+    Colour getTabText (const Colour& bkg, bool isEnabled, bool isHighlighted) const{
+        const int index = isEnabled ? (isHighlighted ? 0 : 1) : 2;
+
+        if (const Derived* d = findDerived (bkg))
+            return d->tabText[index];
+
+        const float alphas[] = { 1.0f, 0.8f, 0.3f };
+        return bkg.contrasting().withMultipliedAlpha (alphas[index]);
+    }
+
+    const Palette palette;
+    const Colour background, winBackground;
+    const Colour light, dark, grey, editBackground;
+    const Colour on, onOver, onDown, off, green, red;
+
+private:
+    enum { numDerived = 12 };
+
+    struct Derived {
+        Colour base, brighter, tabBackground;
+        Colour tabText[3];
+    };
+
+    void setStates (Widget w, Colour n, Colour h, Colour d, Colour dis, Colour t, Colour th, Colour tdis){
+        this->table[w][normal] = n;
+        this->table[w][hover] = h;
+        this->table[w][down] = d;
+        this->table[w][disabled] = dis;
+        this->table[w][toggled] = t;
+        this->table[w][toggledHover] = th;
+        this->table[w][toggledDisabled] = tdis;
+    }
+
+    const Derived* findDerived (const Colour& colour) const{
+        for (int i = 0; i < numDerived; ++i)
+            if (this->derived[i].base == colour)
+                return &this->derived[i];
+        return nullptr;
+    }
+
+    Colour table[numWidgets][numStates];
+    Derived derived[numDerived];
+
+    JUCE_DECLARE_NON_COPYABLE (GrisTheme)
+};
+
+#endif
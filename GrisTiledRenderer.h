@@ -0,0 +1,315 @@
+/*
+ ==============================================================================
+
+ GrisTiledRenderer.h
+
+ Opt-in parallel painting of large editors: the children of a component are
+ rasterised into layers on worker threads and composited on the message thread.
+
+ ==============================================================================
+ */
+
+#ifndef GRISTILEDRENDERER_H_INCLUDED
+#define GRISTILEDRENDERER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/** Replaces the painting of a component and its children.
+
+ Installed with GrisTiledRenderer::enable (editorContent), it is the component's
+ CachedComponentImage, so JUCE hands it every invalidated area and asks it to
+ paint. The invalidated areas are snapped to a grid of tiles; each direct child
+ touching a dirty tile then repaints those tiles of its own layer image on a
+ worker thread, while the message thread waits. The message thread finally paints
+ the component itself, draws the layers in z-order and calls paintOverChildren().
+
+ Work is split by child subtree and not by tile within a child, because a JUCE
+ component's paint() is not written to run on two threads at once. Editors gain
+ when their widgets are spread over several children, e.g. one per panel.
+
+ Child subtrees are painted away from the message thread, so their paint() must
+ not lock the message manager, nor change component state: no setColour(),
+ repaint() or other call that notifies listeners. Reading state is safe, since
+ the message thread is blocked meanwhile. The draw overrides of GrisLookAndFeel
+ keep to this, and its caches, fonts and allocation counters take concurrent
+ calls. Use compareWithSerial() to check an editor before enabling the renderer
+ for it.
+
+ Layers are composited with the transform and the alpha of their child. A
+ transformed child is repainted whole whenever a dirty tile touches it.
+ */
+class GrisTiledRenderer : public CachedComponentImage {
+public:
+    /** Installs a renderer on a component; the component owns it from then on. */
+    static GrisTiledRenderer* enable (Component& component, int numThreads = SystemStats::getNumCpus()){
+        GrisTiledRenderer* renderer = new GrisTiledRenderer (component, numThreads);
+        component.setCachedComponentImage (renderer);
+        return renderer;
+    }
+
+    static void disable (Component& component){
+        if (get (component) != nullptr)
+            component.setCachedComponentImage (nullptr);
+    }
+
+    static GrisTiledRenderer* get (Component& component){
+        return dynamic_cast<GrisTiledRenderer*> (component.getCachedComponentImage());
+    }
+
+    ~GrisTiledRenderer(){
+        if (this->pool != nullptr)
+            this->pool->removeAllJobs (true, 5000);
+    }
+
+    /** Threads painting the children; 1 paints them serially on the message thread. */
+    void setNumThreads (int numThreads){
+        numThreads = jmax (1, numThreads);
+
+        if (numThreads == this->numThreads)
+            return;
+
+        if (this->pool != nullptr)
+            this->pool->removeAllJobs (true, 5000);
+
+        this->numThreads = numThreads;
+        this->pool.reset (numThreads > 1 ? new ThreadPool (numThreads) : nullptr);
+    }
+
+    int getNumThreads() const noexcept  { return this->numThreads; }
+
+    /** Side of the tiles dirty areas are rounded to, in logical pixels. */
+    void setTileSize (int newTileSize)  { this->tileSize = jmax (8, newTileSize); invalidateAll(); }
+
+    //==============================================================================
+    void paint (Graphics& g) override{
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+        if (scale != this->layerScale){
+            this->layerScale = scale;
+            this->layers.clearQuick (true);
+            invalidateAll();
+        }
+
+        const RectangleList<int> dirty (snapToTiles (this->dirtyArea));
+        this->dirtyArea.clear();
+        pruneLayers();
+
+        // prepare the jobs on the message thread: layers sized and their dirty pixels cleared
+        Array<LayerJob*> jobs;
+
+        for (int i = 0; i < this->owner.getNumChildComponents(); ++i){
+            Component* child = this->owner.getChildComponent (i);
+
+            if (! child->isVisible() || child->getAlpha() <= 0.0f || child->getWidth() <= 0 || child->getHeight() <= 0)
+                continue;
+
+            LayerJob* layer = getLayer (*child);
+            RectangleList<int> area;
+
+            if (layer->isNew || (child->isTransformed() && dirty.intersectsRectangle (child->getBoundsInParent()))){
+                area.add (child->getLocalBounds());
+            }else if (! child->isTransformed()){
+                area = dirty;
+                area.clipTo (child->getBounds());
+                area.offsetAll (-child->getX(), -child->getY());
+            }
+
+            layer->isNew = false;
+
+            if (area.isEmpty())
+                continue;
+
+            for (const Rectangle<int>* r = area.begin(); r != area.end(); ++r)
+                layer->image.clear (physical (*r));
+
+            layer->area = area;
+            jobs.add (layer);
+        }
+
+        if (this->pool != nullptr && jobs.size() > 1){
+            for (int i = 0; i < jobs.size(); ++i)
+                this->pool->addJob (jobs.getUnchecked (i), false);
+
+            for (int i = 0; i < jobs.size(); ++i)
+                this->pool->waitForJobToFinish (jobs.getUnchecked (i), -1);
+        }else{
+            for (int i = 0; i < jobs.size(); ++i)
+                jobs.getUnchecked (i)->paintLayer();
+        }
+
+        // composite: the component's own paint, then every child layer in z-order
+        {
+            Graphics::ScopedSaveState state (g);
+            this->owner.paint (g);
+        }
+
+        {
+            Graphics::ScopedSaveState state (g);
+
+            for (int i = 0; i < this->owner.getNumChildComponents(); ++i){
+                Component* child = this->owner.getChildComponent (i);
+
+                if (! child->isVisible() || child->getAlpha() <= 0.0f)
+                    continue;
+
+                if (LayerJob* layer = findLayer (*child)){
+                    // a CachedComponentImage applies the alpha itself, as it does for JUCE
+                    g.setOpacity (child->getCachedComponentImage() != nullptr ? 1.0f : child->getAlpha());
+                    g.drawImageTransformed (layer->image, AffineTransform::scale (1.0f / scale)
+                                                              .translated ((float) child->getX(), (float) child->getY())
+                                                              .followedBy (child->getTransform()));
+                }
+            }
+        }
+
+        this->owner.paintOverChildren (g);
+    }
+
+    bool invalidateAll() override{
+        this->dirtyArea = this->owner.getLocalBounds();
+        return true;
+    }
+
+    bool invalidate (const Rectangle<int>& area) override{
+        this->dirtyArea.add (area.getIntersection (this->owner.getLocalBounds()));
+        return true;
+    }
+
+    void releaseResources() override{
+        this->layers.clearQuick (true);
+        invalidateAll();
+    }
+
+    //==============================================================================
+    /** Paints a component once serially and once through a renderer using numThreads,
+        and returns the number of pixels that differ. 0 means the tiled path is exact.
+     */
+    static int compareWithSerial (Component& component, float scale, int numThreads){
+        const int w = roundToInt (component.getWidth() * scale);
+        const int h = roundToInt (component.getHeight() * scale);
+        Image serial (Image::ARGB, w, h, true, SoftwareImageType());
+        Image tiled (Image::ARGB, w, h, true, SoftwareImageType());
+
+        {
+            Graphics g (serial);
+            g.addTransform (AffineTransform::scale (scale));
+            component.paintEntireComponent (g, true);
+        }
+
+        {
+            GrisTiledRenderer renderer (component, numThreads);
+            Graphics g (tiled);
+            g.addTransform (AffineTransform::scale (scale));
+            renderer.paint (g);
+        }
+
+        const Image::BitmapData a (serial, Image::BitmapData::readOnly);
+        const Image::BitmapData b (tiled, Image::BitmapData::readOnly);
+        int numDifferent = 0;
+
+        for (int y = 0; y < h; ++y)
+            for (int x = 0; x < w; ++x)
+                if (a.getPixelColour (x, y) != b.getPixelColour (x, y))
+                    ++numDifferent;
+
+        return numDifferent;
+    }
+
+private:
+    GrisTiledRenderer (Component& ownerComponent, int numThreadsToUse)
+        : owner (ownerComponent), numThreads (0), tileSize (128), layerScale (0.0f)
+    {
+        setNumThreads (numThreadsToUse);
+        invalidateAll();
+    }
+
+    /** The layer of one child subtree, repainted by a worker. */
+    class LayerJob : public ThreadPoolJob {
+    public:
+        LayerJob (Component& childToPaint, float scaleToUse)
+            : ThreadPoolJob ("GRIS tiled paint"), child (&childToPaint), scale (scaleToUse),
+              image (Image::ARGB, jmax (1, roundToInt (childToPaint.getWidth() * scaleToUse)),
+                     jmax (1, roundToInt (childToPaint.getHeight() * scaleToUse)), true, SoftwareImageType()),
+              size (childToPaint.getWidth(), childToPaint.getHeight()), isNew (true) {}
+
+        JobStatus runJob() override{
+            paintLayer();
+            return jobHasFinished;
+        }
+
+        void paintLayer(){
+            Graphics g (this->image);
+            g.addTransform (AffineTransform::scale (this->scale));
+            g.reduceClipRegion (this->area);
+
+            if (CachedComponentImage* cached = this->child->getCachedComponentImage())
+                cached->paint (g);
+            else
+                this->child->paintEntireComponent (g, true); // the alpha is applied when compositing
+        }
+
+        Component::SafePointer<Component> child;
+        const float scale;
+        Image image;
+        const Point<int> size;
+        RectangleList<int> area;
+        bool isNew;
+    };
+
+    LayerJob* findLayer (Component& child) const{
+        for (int i = 0; i < this->layers.size(); ++i)
+            if (this->layers.getUnchecked (i)->child == &child)
+                return this->layers.getUnchecked (i);
+        return nullptr;
+    }
+
+    LayerJob* getLayer (Component& child){
+        LayerJob* layer = findLayer (child);
+
+        if (layer != nullptr && layer->size == Point<int> (child.getWidth(), child.getHeight()))
+            return layer;
+
+        if (layer != nullptr)
+            this->layers.removeObject (layer);
+
+        return this->layers.add (new LayerJob (child, this->layerScale));
+    }
+
+    void pruneLayers(){
+        for (int i = this->layers.size(); --i >= 0;)
+            if (this->layers.getUnchecked (i)->child == nullptr
+                 || this->layers.getUnchecked (i)->child->getParentComponent() != &this->owner)
+                this->layers.remove (i);
+    }
+
+    RectangleList<int> snapToTiles (const RectangleList<int>& area) const{
+        RectangleList<int> tiles;
+
+        for (const Rectangle<int>* r = area.begin(); r != area.end(); ++r){
+            const int x0 = (r->getX() / this->tileSize) * this->tileSize;
+            const int y0 = (r->getY() / this->tileSize) * this->tileSize;
+            const int x1 = ((r->getRight() + this->tileSize - 1) / this->tileSize) * this->tileSize;
+            const int y1 = ((r->getBottom() + this->tileSize - 1) / this->tileSize) * this->tileSize;
+            tiles.add (Rectangle<int> (x0, y0, x1 - x0, y1 - y0));
+        }
+
+        tiles.clipTo (this->owner.getLocalBounds());
+        return tiles;
+    }
+
+    Rectangle<int> physical (const Rectangle<int>& r) const{
+        return (r.toFloat() * this->layerScale).getSmallestIntegerContainer();
+    }
+
+    Component& owner;
+    int numThreads, tileSize;
+    float layerScale;
+    std::unique_ptr<ThreadPool> pool;
+    OwnedArray<LayerJob> layers;
+    RectangleList<int> dirtyArea;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisTiledRenderer)
+};
+
+#endif
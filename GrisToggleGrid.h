@@ -0,0 +1,240 @@
+/*
+ ==============================================================================
+
+ GrisToggleGrid.h
+
+ A matrix of numbered toggles (solo, mute, speaker or source selection)
+ drawn by one component.
+
+ ==============================================================================
+ */
+
+#ifndef GRISTOGGLEGRID_H_INCLUDED
+#define GRISTOGGLEGRID_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+
+//==============================================================================
+/** Draws numColumns x numRows numbered toggles in a single paint.
+
+ Cells look like the numbered ToggleButtons drawn by GrisLookAndFeel, but they are
+ not components: the cell under the mouse is found arithmetically, and changing
+ states only repaints the cells that actually changed. Cells are numbered from 0,
+ row by row, and labelled index + 1 unless setCellLabel() is used.
+
+ Dragging after a click applies the clicked cell's new state to every cell crossed.
+ */
+class GrisToggleGrid : public Component {
+public:
+    class Listener {
+    public:
+        virtual ~Listener() {}
+
+        /** Called when the user changes a cell, once per cell crossed while dragging. */
+        virtual void toggleGridCellChanged (GrisToggleGrid* grid, int cellIndex, bool isOn) = 0;
+    };
+
+    GrisToggleGrid (GrisLookAndFeel& lookAndFeel, int numColumnsToUse, int numRowsToUse)
+        : lnf (lookAndFeel), numColumns (0), numRows (0),
+          hoveredCell (-1), pressedCell (-1), dragState (false)
+    {
+        setGridSize (numColumnsToUse, numRowsToUse);
+    }
+
+    void addListener (Listener* l)      { this->listeners.add (l); }
+    void removeListener (Listener* l)   { this->listeners.remove (l); }
+
+    void setGridSize (int newNumColumns, int newNumRows){
+        this->numColumns = jmax (1, newNumColumns);
+        this->numRows = jmax (1, newNumRows);
+        this->states.clear();
+        this->disabled.clear();
+        this->labels.clear();
+
+        for (int i = 0; i < getNumCells(); ++i)
+            this->labels.add (String (i + 1));
+
+        // every label is drawn on each full paint, and the columns come in two widths
+        this->lnf.getTextLayoutCache().reserve (2 * getNumCells());
+        repaint();
+    }
+
+    int getNumColumns() const noexcept  { return this->numColumns; }
+    int getNumRows() const noexcept     { return this->numRows; }
+    int getNumCells() const noexcept    { return this->numColumns * this->numRows; }
+
+    void setCellLabel (int cellIndex, const String& label){
+        if (isPositiveAndBelow (cellIndex, getNumCells()) && this->labels[cellIndex] != label){
+            this->labels.set (cellIndex, label);
+            repaint (getCellBounds (cellIndex));
+        }
+    }
+
+    bool getCellState (int cellIndex) const                 { return this->states[cellIndex]; }
+    const BigInteger& getCellStates() const noexcept         { return this->states; }
+
+    void setCellState (int cellIndex, bool isOn, NotificationType notification = dontSendNotification){
+        if (! isPositiveAndBelow (cellIndex, getNumCells()) || this->states[cellIndex] == isOn)
+            return;
+
+        this->states.setBit (cellIndex, isOn);
+        repaint (getCellBounds (cellIndex));
+
+        if (notification != dontSendNotification)
+            this->listeners.call (&Listener::toggleGridCellChanged, this, cellIndex, isOn);
+    }
+
+    /** Replaces every state at once; bit i is cell i. Only the cells that differ are repainted. */
+    void setCellStates (const BigInteger& newStates){
+        BigInteger changed (this->states);
+        changed ^= newStates;
+        this->states = newStates;
+        this->states.setRange (getNumCells(), jmax (0, this->states.getHighestBit() + 1 - getNumCells()), false);
+
+        for (int i = changed.findNextSetBit (0); isPositiveAndBelow (i, getNumCells()); i = changed.findNextSetBit (i + 1))
+            repaint (getCellBounds (i));
+    }
+
+    void setCellEnabled (int cellIndex, bool isEnabled){
+        if (isPositiveAndBelow (cellIndex, getNumCells()) && this->disabled[cellIndex] == isEnabled){
+            this->disabled.setBit (cellIndex, ! isEnabled);
+            repaint (getCellBounds (cellIndex));
+        }
+    }
+
+    bool isCellEnabled (int cellIndex) const{
+        return isEnabled() && ! this->disabled[cellIndex];
+    }
+
+    Rectangle<int> getCellBounds (int cellIndex) const{
+        const int column = cellIndex % this->numColumns;
+        const int row = cellIndex / this->numColumns;
+        const int x0 = (column * getWidth()) / this->numColumns;
+        const int x1 = ((column + 1) * getWidth()) / this->numColumns;
+        const int y0 = (row * getHeight()) / this->numRows;
+        const int y1 = ((row + 1) * getHeight()) / this->numRows;
+        return Rectangle<int> (x0, y0, x1 - x0, y1 - y0);
+    }
+
+    /** The cell under a point in local coordinates, or -1. */
+    int getCellAt (Point<int> position) const{
+        if (! getLocalBounds().contains (position))
+            return -1;
+
+        const int column = jmin (this->numColumns - 1, (position.x * this->numColumns) / jmax (1, getWidth()));
+        const int row = jmin (this->numRows - 1, (position.y * this->numRows) / jmax (1, getHeight()));
+        return row * this->numColumns + column;
+    }
+
+    void paint (Graphics& g) override{
+        const GrisTheme& t = this->lnf.getTheme();
+        const Font& font = this->lnf.getScaledFont (g.getInternalContext().getPhysicalPixelScaleFactor());
+        const Colour textColour (this->lnf.findColour (ToggleButton::textColourId));
+        const Rectangle<int> clip (g.getClipBounds().getIntersection (getLocalBounds()));
+
+        if (clip.isEmpty())
+            return;
+
+        const int firstColumn = (clip.getX() * this->numColumns) / jmax (1, getWidth());
+        const int lastColumn = jmin (this->numColumns - 1, ((clip.getRight() - 1) * this->numColumns) / jmax (1, getWidth()));
+        const int firstRow = (clip.getY() * this->numRows) / jmax (1, getHeight());
+        const int lastRow = jmin (this->numRows - 1, ((clip.getBottom() - 1) * this->numRows) / jmax (1, getHeight()));
+
+        g.setFont (font);
+
+        for (int row = firstRow; row <= lastRow; ++row){
+            for (int column = firstColumn; column <= lastColumn; ++column){
+                const int index = row * this->numColumns + column;
+                const Rectangle<int> cell (getCellBounds (index));
+                const bool enabled = isCellEnabled (index);
+
+                // same geometry as drawTickBox for a one-character ToggleButton
+                const float boxSize = cell.getWidth() * 0.8f;
+                const Rectangle<float> box ((float) cell.getX(), cell.getY() + (cell.getHeight() - boxSize) * 0.5f, boxSize, boxSize);
+
+                g.setColour (t.getColour (GrisTheme::tickBox, GrisTheme::getState (enabled, this->states[index],
+                                                                                     index == this->hoveredCell,
+                                                                                     enabled && index == this->pressedCell)));
+                g.fillRect (box);
+
+                g.setColour (enabled ? textColour : textColour.withMultipliedAlpha (0.5f));
+                const Graphics::ScopedSaveState state (g);
+                g.setOrigin (cell.getX(), cell.getY());
+                this->lnf.getTextLayoutCache().drawFittedText (g, font, this->labels[index], -2, 1, cell.getWidth(), cell.getHeight(),
+                                                               Justification::centred, 10);
+            }
+        }
+    }
+
+    void mouseMove (const MouseEvent& e) override{
+        setHoveredCell (getCellAt (e.getPosition()));
+    }
+
+    void mouseExit (const MouseEvent&) override{
+        setHoveredCell (-1);
+    }
+
+    void mouseDown (const MouseEvent& e) override{
+        const int cell = getCellAt (e.getPosition());
+
+        if (cell < 0 || ! isCellEnabled (cell))
+            return;
+
+        this->pressedCell = cell;
+        this->dragState = ! this->states[cell];
+        setCellState (cell, this->dragState, sendNotificationSync);
+    }
+
+    void mouseDrag (const MouseEvent& e) override{
+        if (this->pressedCell < 0)
+            return;
+
+        const int cell = getCellAt (e.getPosition());
+        setHoveredCell (cell);
+
+        if (cell >= 0 && cell != this->pressedCell && isCellEnabled (cell)){
+            const int previous = this->pressedCell;
+            this->pressedCell = cell;
+            repaint (getCellBounds (previous));
+            setCellState (cell, this->dragState, sendNotificationSync);
+        }
+    }
+
+    void mouseUp (const MouseEvent&) override{
+        if (this->pressedCell >= 0)
+            repaint (getCellBounds (this->pressedCell));
+
+        this->pressedCell = -1;
+    }
+
+    void enablementChanged() override{
+        repaint();
+    }
+
+private:
+    void setHoveredCell (int cell){
+        if (cell == this->hoveredCell)
+            return;
+
+        if (this->hoveredCell >= 0)
+            repaint (getCellBounds (this->hoveredCell));
+
+        this->hoveredCell = cell;
+
+        if (cell >= 0)
+            repaint (getCellBounds (cell));
+    }
+
+    GrisLookAndFeel& lnf;
+    int numColumns, numRows;
+    BigInteger states, disabled;
+    StringArray labels;
+    int hoveredCell, pressedCell;
+    bool dragState;
+    ListenerList<Listener> listeners;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisToggleGrid)
+};
+
+#endif
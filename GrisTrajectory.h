@@ -0,0 +1,320 @@
+/*
+ ==============================================================================
+
+ GrisTrajectory.h
+
+ Bounded storage of a source trajectory, fed from the audio or automation
+ thread, and the view drawing it.
+
+ ==============================================================================
+ */
+
+#ifndef GRISTRAJECTORY_H_INCLUDED
+#define GRISTRAJECTORY_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "GrisLookAndFeel.h"
+#include "GrisRepaintScheduler.h"
+
+#include <vector>
+
+//==============================================================================
+/** The last points of a trajectory, kept at several levels of detail.
+
+ One thread pushes positions into a lock-free FIFO; the message thread calls
+ update(), which moves them into a pyramid of fixed-capacity rings. Level 0 keeps
+ a point when it is at least the base tolerance away from the previous point it
+ kept, and each following level doubles the tolerance, so a level holds at most
+ as many points as the one below it over the same stretch of trajectory. Every
+ ring has the same capacity, so a coarser level covers at least the stretch of a
+ finer one: about twice as much when the points are dense, the same when they are
+ further apart than its tolerance. Zooming out therefore never shortens the tail
+ shown. When a ring is full its oldest points are overwritten.
+
+ A view draws the coarsest level whose tolerance is still below a pixel, which
+ bounds the number of segments by the screen resolution rather than by how long
+ the trajectory has been playing.
+ */
+class GrisTrajectory {
+public:
+    struct Update {
+        /** Bounds of the segments added to and dropped from the level asked for, in trajectory
+            units; may have no width or height.
+         */
+        Rectangle<float> area;
+        bool hasArea = false;
+
+        /** True when points fell off the end of that level's ring; their segments are in area. */
+        bool evicted = false;
+
+        bool isEmpty() const noexcept   { return ! this->hasArea && ! this->evicted; }
+
+        void include (Point<float> p) noexcept{
+            this->area = this->hasArea ? Rectangle<float>::leftTopRightBottom (jmin (this->area.getX(), p.x), jmin (this->area.getY(), p.y),
+                                                                               jmax (this->area.getRight(), p.x), jmax (this->area.getBottom(), p.y))
+                                       : Rectangle<float> (p.x, p.y, 0.0f, 0.0f);
+            this->hasArea = true;
+        }
+    };
+
+    /** pointsPerLevel is the capacity of the ring of each level. */
+    GrisTrajectory (int pointsPerLevel = 4096, int numLevelsToUse = 5, int fifoSize = 2048)
+        : fifo (fifoSize), pending ((size_t) fifoSize),
+          baseTolerance (0.002f), numDropped (0), hasHead (false)
+    {
+        for (int i = 0; i < jmax (1, numLevelsToUse); ++i)
+            this->levels.add (new Level (pointsPerLevel));
+    }
+
+    //==============================================================================
+    /** Producer thread: adds a position. Returns false when the FIFO was full and the
+        point was dropped, e.g. because the editor is closed and nothing calls update().
+     */
+    bool push (float x, float y) noexcept{
+        int start1, size1, start2, size2;
+        this->fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0){
+            ++this->numDropped;
+            return false;
+        }
+
+        this->pending[(size_t) (size1 > 0 ? start1 : start2)] = Point<float> (x, y);
+        this->fifo.finishedWrite (1);
+        return true;
+    }
+
+    int64 getNumDropped() const noexcept    { return this->numDropped.get(); }
+
+    //==============================================================================
+    /** Message thread: smallest distance between the points kept at level 0, in trajectory units. */
+    void setBaseTolerance (float tolerance) noexcept    { this->baseTolerance = jmax (1.0e-6f, tolerance); }
+    float getTolerance (int level) const noexcept       { return this->baseTolerance * (float) (1 << level); }
+
+    /** Message thread: moves the pushed points into the levels, and reports what changed
+        in one of them, e.g. the level a view draws.
+     */
+    Update update (int levelToReport = 0){
+        Update u;
+        int start1, size1, start2, size2;
+        this->fifo.prepareToRead (this->fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            add (this->pending[(size_t) (start1 + i)], levelToReport, u);
+        for (int i = 0; i < size2; ++i)
+            add (this->pending[(size_t) (start2 + i)], levelToReport, u);
+
+        this->fifo.finishedRead (size1 + size2);
+        return u;
+    }
+
+    /** Message thread: forgets every point, including those still in the FIFO. */
+    void clear(){
+        this->fifo.finishedRead (this->fifo.getNumReady());
+
+        for (int i = 0; i < this->levels.size(); ++i)
+            this->levels.getUnchecked (i)->clear();
+
+        this->hasHead = false;
+    }
+
+    int getNumLevels() const noexcept           { return this->levels.size(); }
+    int getNumPoints (int level) const noexcept { return this->levels.getUnchecked (level)->count; }
+
+    /** Point i of a level, 0 being the oldest still kept. */
+    Point<float> getPoint (int level, int i) const noexcept{
+        const Level& l = *this->levels.getUnchecked (level);
+        return l.points[(size_t) ((l.first + i) % (int) l.points.size())];
+    }
+
+    /** The last position received, whether or not a level kept it. */
+    bool getHead (Point<float>& head) const noexcept{
+        head = this->head;
+        return this->hasHead;
+    }
+
+    /** The coarsest level whose tolerance is below maxError, e.g. one pixel in trajectory units. */
+    int chooseLevel (float maxError) const noexcept{
+        int level = 0;
+        while (level + 1 < getNumLevels() && getTolerance (level + 1) <= maxError)
+            ++level;
+        return level;
+    }
+
+private:
+    struct Level {
+        explicit Level (int capacity) : points ((size_t) jmax (2, capacity)), first (0), count (0) {}
+
+        void clear() noexcept   { this->first = this->count = 0; }
+
+        std::vector<Point<float>> points;
+        int first, count;
+    };
+
+    void add (Point<float> p, int levelToReport, Update& u){
+        this->head = p;
+        this->hasHead = true;
+
+        for (int i = 0; i < this->levels.size(); ++i){
+            Level& l = *this->levels.getUnchecked (i);
+            const int size = (int) l.points.size();
+
+            if (l.count > 0){
+                const Point<float> last (l.points[(size_t) ((l.first + l.count - 1) % size)]);
+                const float tolerance = getTolerance (i);
+
+                if (last.getDistanceSquaredFrom (p) < tolerance * tolerance)
+                    continue;
+
+                if (i == levelToReport){
+                    u.include (last);
+                    u.include (p);
+                }
+            }
+
+            if (l.count == size){
+                // the segment from the oldest point to the next one goes away
+                if (i == levelToReport){
+                    u.include (l.points[(size_t) l.first]);
+                    u.include (l.points[(size_t) ((l.first + 1) % size)]);
+                    u.evicted = true;
+                }
+
+                l.first = (l.first + 1) % size;
+            }else{
+                ++l.count;
+            }
+
+            l.points[(size_t) ((l.first + l.count - 1) % size)] = p;
+        }
+    }
+
+    AbstractFifo fifo;
+    std::vector<Point<float>> pending;
+    OwnedArray<Level> levels;
+    float baseTolerance;
+    Atomic<int64> numDropped;
+    Point<float> head;
+    bool hasHead;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisTrajectory)
+};
+
+//==============================================================================
+/** Draws a GrisTrajectory whose coordinates span -1 to 1 on both axes.
+
+ The view polls its trajectory on each tick of the shared GrisRepaintScheduler
+ and only repaints the area of the segments added and dropped, and paints only the
+ segments that cross the clip region. The line uses the on colour of the look and
+ feel, the current position a dot of its light colour.
+ */
+class GrisTrajectoryView : public Component, public GrisRepaintScheduler::Client {
+public:
+    GrisTrajectoryView (GrisLookAndFeel& lookAndFeel, GrisTrajectory& trajectoryToShow)
+        : GrisRepaintScheduler::Client (static_cast<Component&> (*this)),
+          lnf (lookAndFeel), trajectory (trajectoryToShow),
+          lineThickness (1.5f), headDiameter (6.0f)
+    {
+        setInterceptsMouseClicks (false, false);
+        setPolling (true);
+    }
+
+    void setLineThickness (float thickness)     { this->lineThickness = thickness; repaint(); }
+    void setHeadDiameter (float diameter)       { this->headDiameter = diameter; repaint(); }
+
+    void paint (Graphics& g) override{
+        const float pixelsPerUnit = getPixelsPerUnit();
+        const int level = this->trajectory.chooseLevel (1.0f / pixelsPerUnit);
+        const int n = this->trajectory.getNumPoints (level);
+        const AffineTransform toView (getUnitsToView());
+
+        // segments outside this cannot reach the clip, even through a mitred joint
+        const Rectangle<float> clip (g.getClipBounds().toFloat().expanded (this->lineThickness * 3.0f + 2.0f));
+
+        Point<float> head;
+        const bool hasHead = this->trajectory.getHead (head);
+        head = head.transformedBy (toView);
+
+        this->path.clear();
+        this->path.preallocateSpace (n * 3 + 6);
+
+        Point<float> previous;
+        bool connected = false;
+
+        for (int i = 0; i <= n; ++i){
+            if (i == n && ! hasHead)
+                break;
+
+            const Point<float> p (i < n ? this->trajectory.getPoint (level, i).transformedBy (toView) : head);
+
+            if (i > 0 && touches (clip, previous, p)){
+                if (! connected)
+                    this->path.startNewSubPath (previous);
+
+                this->path.lineTo (p);
+                connected = true;
+            }else{
+                connected = false;
+            }
+
+            previous = p;
+        }
+
+        g.setColour (this->lnf.getOnColour());
+        g.strokePath (this->path, PathStrokeType (this->lineThickness));
+
+        if (hasHead){
+            g.setColour (this->lnf.getLightColour());
+            g.fillEllipse (Rectangle<float> (this->headDiameter, this->headDiameter).withCentre (head));
+        }
+    }
+
+private:
+    static bool touches (const Rectangle<float>& clip, Point<float> a, Point<float> b) noexcept{
+        return jmax (a.x, b.x) >= clip.getX() && jmin (a.x, b.x) <= clip.getRight()
+            && jmax (a.y, b.y) >= clip.getY() && jmin (a.y, b.y) <= clip.getBottom();
+    }
+
+    float getPixelsPerUnit() const{
+        return jmax (1.0f, jmin (getWidth(), getHeight()) * 0.5f);
+    }
+
+    AffineTransform getUnitsToView() const{
+        const float s = getPixelsPerUnit();
+        return AffineTransform::scale (s, -s).translated (getWidth() * 0.5f, getHeight() * 0.5f);
+    }
+
+    void handleRepaint() override{
+        const int level = this->trajectory.chooseLevel (1.0f / getPixelsPerUnit());
+        const int numBefore = this->trajectory.getNumPoints (level);
+        const Point<float> lastKept (numBefore > 0 ? this->trajectory.getPoint (level, numBefore - 1) : Point<float>());
+        Point<float> previousHead, head;
+        const bool hadHead = this->trajectory.getHead (previousHead);
+
+        // the segments added to and dropped from the level drawn...
+        GrisTrajectory::Update changed (this->trajectory.update (level));
+
+        if (! this->trajectory.getHead (head) || (hadHead && head == previousHead && changed.isEmpty()))
+            return;
+
+        // ...and the line from the last point kept to the head, before and after
+        changed.include (hadHead ? previousHead : head);
+        changed.include (head);
+
+        if (numBefore > 0)
+            changed.include (lastKept);
+
+        const Rectangle<float> area (changed.area);
+        const float margin = jmax (this->lineThickness * 3.0f, this->headDiameter * 0.5f) + 2.0f;
+        repaint (area.transformedBy (getUnitsToView()).expanded (margin).getSmallestIntegerContainer());
+    }
+
+    GrisLookAndFeel& lnf;
+    GrisTrajectory& trajectory;
+    float lineThickness, headDiameter;
+    Path path;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GrisTrajectoryView)
+};
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ ==============================================================================
+
+ GrisWorkerPool.h
+
+ Background threads shared by every GRIS plugin instance of a process, used
+ to prepare fonts and sprites away from the message thread.
+
+ ==============================================================================
+ */
+
+#ifndef GRISWORKERPOOL_H_INCLUDED
+#define GRISWORKERPOOL_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//==============================================================================
+/** Hold it through a SharedResourcePointer<GrisWorkerPool>, so that one pool
+ serves every instance and is stopped with the last of them.
+ */
+class GrisWorkerPool {
+public:
+    GrisWorkerPool() : pool (jlimit (1, 4, SystemStats::getNumCpus() - 1)) {}
+
+    ~GrisWorkerPool(){
+        this->pool.removeAllJobs (true, 2000);
+    }
+
+    ThreadPool& getPool() noexcept{
+        return this->pool;
+    }
+
+private:
+    ThreadPool pool;
+
+    JUCE_DECLARE_NON_COPYABLE (GrisWorkerPool)
+};
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ ==============================================================================
+
+ GrisDeltaSliderTests.cpp
+
+ Checks that GrisDeltaSlider draws what a juce::Slider drawn by GrisLookAndFeel
+ draws, and the strip it repaints when its value changes.
+
+ ==============================================================================
+ */
+
+#include "../GrisDeltaSlider.h"
+
+class GrisDeltaSliderTests : public UnitTest {
+public:
+    GrisDeltaSliderTests() : UnitTest ("GrisDeltaSlider", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+
+        beginTest ("Same pixels as a juce::Slider");
+        expectEquals (countDifferentPixels (lnf, false, 200, 20, 0.3), 0);
+        expectEquals (countDifferentPixels (lnf, true, 20, 200, 0.7), 0);
+
+        beginTest ("Horizontal repaint area");
+        {
+            GrisDeltaSlider slider (lnf);
+            slider.setSize (200, 20);
+
+            expect (slider.getRepaintArea (0.5, 0.5).isEmpty());
+            expect (slider.getRepaintArea (0.5, 0.5001).isEmpty());
+
+            // thumb radius 9, so the thumb moves from x = 100 to x = 118.2
+            const Rectangle<int> area (slider.getRepaintArea (0.5, 0.6));
+            expectEquals (area.getY(), 0);
+            expectEquals (area.getHeight(), 20);
+            expect (area.getX() <= 96);
+            expect (area.getRight() >= 121);
+            expect (area.getWidth() < 40);
+
+            expect (slider.getRepaintArea (0.6, 0.5) == area);
+        }
+
+        beginTest ("Vertical repaint area");
+        {
+            GrisDeltaSlider slider (lnf, true);
+            slider.setSize (20, 200);
+
+            // the thumb reaches down the track, so everything below the higher one is repainted
+            const Rectangle<int> area (slider.getRepaintArea (0.2, 0.4));
+            expectEquals (area.getX(), 0);
+            expectEquals (area.getWidth(), 20);
+            expectEquals (area.getBottom(), 200);
+            expect (area.getY() > 0);
+            expect (slider.getRepaintArea (0.4, 0.4).isEmpty());
+        }
+
+        beginTest ("Values are constrained to the range and interval");
+        {
+            GrisDeltaSlider slider (lnf);
+            slider.setRange (0.0, 10.0, 0.5);
+            slider.setValue (3.3, dontSendNotification);
+            expectEquals (slider.getValue(), 3.5);
+            slider.setValue (12.0, dontSendNotification);
+            expectEquals (slider.getValue(), 10.0);
+        }
+    }
+
+private:
+    static int countDifferentPixels (GrisLookAndFeel& lnf, bool vertical, int width, int height, double value){
+        Slider reference (vertical ? Slider::LinearVertical : Slider::LinearHorizontal, Slider::NoTextBox);
+        reference.setLookAndFeel (&lnf);
+        reference.setRange (0.0, 1.0);
+        reference.setValue (value, dontSendNotification);
+        reference.setSize (width, height);
+
+        GrisDeltaSlider slider (lnf, vertical);
+        slider.setValue (value, dontSendNotification);
+        slider.setSize (width, height);
+
+        Image expected (Image::ARGB, width, height, true, SoftwareImageType());
+        Image actual (Image::ARGB, width, height, true, SoftwareImageType());
+
+        {
+            Graphics g (expected);
+            reference.paintEntireComponent (g, true);
+        }
+
+        {
+            Graphics g (actual);
+            slider.paintEntireComponent (g, true);
+        }
+
+        reference.setLookAndFeel (nullptr);
+
+        const Image::BitmapData a (expected, Image::BitmapData::readOnly);
+        const Image::BitmapData b (actual, Image::BitmapData::readOnly);
+        int numDifferent = 0;
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                if (a.getPixelColour (x, y) != b.getPixelColour (x, y))
+                    ++numDifferent;
+
+        return numDifferent;
+    }
+};
+
+static GrisDeltaSliderTests grisDeltaSliderTests;
@@ -0,0 +1,56 @@
+/*
+ ==============================================================================
+
+ GrisFieldRendererTests.cpp
+
+ Checks that GrisFieldRenderer draws overlapping markers back to front and picks
+ the one on top.
+
+ ==============================================================================
+ */
+
+#include "../GrisFieldRenderer.h"
+
+class GrisFieldRendererTests : public UnitTest {
+public:
+    GrisFieldRendererTests() : UnitTest ("GrisFieldRenderer", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+        GrisFieldRenderer renderer (lnf);
+        const Rectangle<float> viewport (0.0f, 0.0f, 100.0f, 100.0f);
+
+        // seen from above, both points fall on the centre and the higher one is the nearer
+        renderer.setViewAngles (0.0f, float_Pi * 0.5f);
+
+        for (int nearIndex = 0; nearIndex < 2; ++nearIndex){
+            beginTest ("Overlapping points, the nearer at index " + String (nearIndex));
+
+            const int farIndex = 1 - nearIndex;
+            GrisFieldPoints points (2);
+            points.setNumPoints (2);
+            points.setPoint (nearIndex, 0.0f, 0.0f, 0.5f, GrisFieldPoints::source);
+            points.setPoint (farIndex, 0.0f, 0.0f, -0.5f, GrisFieldPoints::speaker);
+
+            renderer.project (points, viewport);
+            expect (renderer.getScreenPosition (0).getDistanceFrom (viewport.getCentre()) < 0.001f);
+            expect (renderer.getScreenPosition (1).getDistanceFrom (viewport.getCentre()) < 0.001f);
+
+            Image image (Image::ARGB, 100, 100, true);
+            {
+                Graphics g (image);
+                renderer.draw (g, points);
+            }
+
+            expectEquals (renderer.getNumVisible(), 2);
+            expectEquals (renderer.getVisiblePoint (0), farIndex);
+            expectEquals (renderer.getVisiblePoint (1), nearIndex);
+            expectEquals (renderer.getPointAt (viewport.getCentre()), nearIndex);
+        }
+
+        beginTest ("Nothing to pick away from the markers");
+        expectEquals (renderer.getPointAt (Point<float> (5.0f, 5.0f)), -1);
+    }
+};
+
+static GrisFieldRendererTests grisFieldRendererTests;
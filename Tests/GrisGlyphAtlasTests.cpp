@@ -0,0 +1,138 @@
+/*
+ ==============================================================================
+
+ GrisGlyphAtlasTests.cpp
+
+ Checks that GrisGlyphAtlas maps back the file it wrote, that stale, truncated
+ or corrupt cache files are rejected so that they get rebuilt, and that
+ GrisGlyphAtlasCache prepares atlases in the directory it is given.
+
+ ==============================================================================
+ */
+
+#include "../GrisGlyphAtlas.h"
+
+#include <cstddef>
+
+class GrisGlyphAtlasTests : public UnitTest {
+public:
+    GrisGlyphAtlasTests() : UnitTest ("GrisGlyphAtlas", "GRIS") {}
+
+    void runTest() override{
+        SharedResourcePointer<GrisSharedTypeface> typeface;
+        const Font font (Font (typeface->getTypeface()).withHeight (GrisFontMetrics::getBaseHeight()));
+        const uint64 fontHash = typeface->getDataHash();
+        const float height = font.getHeight();
+        const float scale = 2.0f;
+        const TemporaryFile temp (".atlas");
+        const File& file = temp.getFile();
+
+        beginTest ("Written atlas maps back");
+        {
+            GrisGlyphAtlas::Ptr built (GrisGlyphAtlas::build (font, fontHash, scale));
+            expect (built->getNumGlyphs() > 0);
+            expect (built->writeTo (file));
+
+            GrisGlyphAtlas::Ptr loaded (GrisGlyphAtlas::load (file, fontHash, height, scale));
+            expect (loaded != nullptr);
+
+            if (loaded != nullptr){
+                expect (loaded->isMapped());
+                expectEquals (loaded->getNumGlyphs(), built->getNumGlyphs());
+                expect (loaded->canDraw ("-12.5 dB"));
+                expect (loaded->canDraw ("90 \xc2\xb0"));
+                expect (! loaded->canDraw ("\xe2\x82\xac"));
+                expectEquals (loaded->getStringWidth ("-12.5 dB"), built->getStringWidth ("-12.5 dB"));
+            }
+        }
+
+        MemoryBlock valid;
+        expect (file.loadFileAsData (valid));
+        const size_t headerSize = sizeof (GrisGlyphAtlas::FileHeader);
+
+        beginTest ("Stale atlas is rejected");
+        expect (GrisGlyphAtlas::load (file, fontHash + 1, height, scale) == nullptr);
+        expect (GrisGlyphAtlas::load (file, fontHash, height + 1.0f, scale) == nullptr);
+        expect (GrisGlyphAtlas::load (file, fontHash, height, 1.0f) == nullptr);
+        {
+            MemoryBlock data (valid);
+            data[offsetof (GrisGlyphAtlas::FileHeader, version)] ^= 0x7f;
+            expectRejected (file, data, fontHash, height, scale);
+        }
+        {
+            MemoryBlock data (valid);
+            data[offsetof (GrisGlyphAtlas::FileHeader, magic)] ^= 0x7f;
+            expectRejected (file, data, fontHash, height, scale);
+        }
+
+        beginTest ("Truncated atlas is rejected");
+        expectRejected (file, MemoryBlock(), fontHash, height, scale);
+        expectRejected (file, MemoryBlock (valid.getData(), headerSize - 1), fontHash, height, scale);
+        expectRejected (file, MemoryBlock (valid.getData(), headerSize), fontHash, height, scale);
+        expectRejected (file, MemoryBlock (valid.getData(), valid.getSize() - 1), fontHash, height, scale);
+
+        beginTest ("Corrupt atlas is rejected");
+        {
+            MemoryBlock data (valid);
+            data[headerSize] ^= 0x01;
+            expectRejected (file, data, fontHash, height, scale);
+        }
+        {
+            MemoryBlock data (valid);
+            data[valid.getSize() - 1] ^= 0x01;
+            expectRejected (file, data, fontHash, height, scale);
+        }
+        {
+            MemoryBlock data (valid);
+            data.append ("x", 1);
+            expectRejected (file, data, fontHash, height, scale);
+        }
+
+        beginTest ("Missing atlas is rejected");
+        expect (file.deleteFile());
+        expect (GrisGlyphAtlas::load (file, fontHash, height, scale) == nullptr);
+
+        beginTest ("Cache prepares atlases in its directory");
+        const File directory (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("GrisGlyphAtlasCache", String()));
+        {
+            GrisGlyphAtlasCache cache;
+            cache.setCacheDirectory (directory);
+            expect (cache.getCacheDirectory() == directory);
+            expect (cache.find (fontHash, height, scale) == nullptr);
+
+            cache.prepare (font, fontHash, scale);
+            GrisGlyphAtlas::Ptr prepared;
+
+            for (int i = 0; i < 500 && prepared == nullptr; ++i){
+                Thread::sleep (10);
+                prepared = cache.find (fontHash, height, scale);
+            }
+
+            expect (prepared != nullptr);
+            expectEquals (cache.getNumBuilt(), 1);
+            expectEquals (directory.getNumberOfChildFiles (File::findFiles), 1);
+            expect (cache.get (font, fontHash, scale) == prepared);
+        }
+
+        beginTest ("Another cache maps the atlas written");
+        {
+            GrisGlyphAtlasCache cache;
+            cache.setCacheDirectory (directory);
+
+            GrisGlyphAtlas::Ptr mapped (cache.get (font, fontHash, scale));
+            expect (mapped->isMapped());
+            expectEquals (cache.getNumMapped(), 1);
+            expectEquals (cache.getNumBuilt(), 0);
+        }
+
+        directory.deleteRecursively();
+    }
+
+private:
+    void expectRejected (const File& file, const MemoryBlock& data, uint64 fontHash, float height, float scale){
+        expect (file.replaceWithData (data.getData(), data.getSize()));
+        expect (GrisGlyphAtlas::load (file, fontHash, height, scale) == nullptr);
+    }
+};
+
+static GrisGlyphAtlasTests grisGlyphAtlasTests;
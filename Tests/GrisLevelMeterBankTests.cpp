@@ -0,0 +1,62 @@
+/*
+ ==============================================================================
+
+ GrisLevelMeterBankTests.cpp
+
+ Checks that GrisLevelMeterBank only reports the bars whose level or peak moved
+ by at least one pixel.
+
+ ==============================================================================
+ */
+
+#include "../GrisLevelMeterBank.h"
+
+class GrisLevelMeterBankTests : public UnitTest {
+public:
+    GrisLevelMeterBankTests() : UnitTest ("GrisLevelMeterBank", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+        GrisMeterLevels levels (8);
+        GrisLevelMeterBank bank (lnf, levels, 2);
+        bank.setSize (80, 200);
+
+        beginTest ("Bar layout");
+        expect (bank.getBarBounds (0) == Rectangle<int> (0, 0, 19, 99));
+        expect (bank.getBarBounds (3) == Rectangle<int> (60, 0, 19, 99));
+        expect (bank.getBarBounds (4) == Rectangle<int> (0, 100, 19, 99));
+
+        beginTest ("Nothing changed after a resize");
+        expect (bank.collectChangedBars().isEmpty());
+
+        beginTest ("Only the bar that moved is reported");
+        levels.setLevel (5, 0.5f);
+        {
+            const RectangleList<int> changed (bank.collectChangedBars());
+            expectEquals (changed.getNumRectangles(), 1);
+            expect (changed.getRectangle (0) == bank.getBarBounds (5));
+        }
+        expect (bank.collectChangedBars().isEmpty());
+
+        beginTest ("Moves under a pixel are not reported");
+        levels.setLevel (5, 0.5001f);
+        expect (bank.collectChangedBars().isEmpty());
+
+        beginTest ("The peak holds, and resetting it is a change");
+        levels.setLevel (5, 0.0f);
+        expectEquals (bank.collectChangedBars().getNumRectangles(), 1);
+        expectEquals (levels.getPeak (5), 0.5001f);
+
+        levels.resetPeak (5);
+        expectEquals (bank.collectChangedBars().getNumRectangles(), 1);
+        expect (bank.collectChangedBars().isEmpty());
+
+        beginTest ("Several bars");
+        for (int i = 0; i < 8; i += 2)
+            levels.setLevel (i, 1.0f);
+
+        expectEquals (bank.collectChangedBars().getNumRectangles(), 4);
+    }
+};
+
+static GrisLevelMeterBankTests grisLevelMeterBankTests;
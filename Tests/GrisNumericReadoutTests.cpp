@@ -0,0 +1,75 @@
+/*
+ ==============================================================================
+
+ GrisNumericReadoutTests.cpp
+
+ Checks the text GrisNumericReadout::format() writes: rounding, signs, values
+ too large to show and truncation to the destination buffer.
+
+ ==============================================================================
+ */
+
+#include "../GrisNumericReadout.h"
+
+#include <limits>
+
+class GrisNumericReadoutTests : public UnitTest {
+public:
+    GrisNumericReadoutTests() : UnitTest ("GrisNumericReadout", "GRIS") {}
+
+    void runTest() override{
+        beginTest ("Rounding");
+        expectFormat (1.25, 1, false, "", "1.3");
+        expectFormat (-1.25, 1, false, "", "-1.3");
+        expectFormat (9.96, 1, false, "", "10.0");
+        expectFormat (2.5, 0, false, "", "3");
+        expectFormat (0.123456, 3, false, "", "0.123");
+        expectFormat (12.0, 2, false, " dB", "12.00 dB");
+
+        beginTest ("Sign");
+        expectFormat (3.0, 0, true, "", "+3");
+        expectFormat (-3.0, 0, true, "", "-3");
+        expectFormat (-3.0, 0, false, "", "-3");
+        expectFormat (-0.0, 1, false, "", "0.0");
+        expectFormat (-0.0, 1, true, "", "0.0");
+        expectFormat (-0.04, 1, false, "", "0.0");
+        expectFormat (0.04, 1, true, "", "0.0");
+
+        beginTest ("Overflow");
+        expectFormat (1.0e15, 0, false, "", "---");
+        expectFormat (-1.0e14, 1, false, " dB", "--- dB");
+        expectFormat (std::numeric_limits<double>::infinity(), 1, false, "", "---");
+        expectFormat (-std::numeric_limits<double>::infinity(), 1, true, "", "---");
+        expectFormat (std::numeric_limits<double>::quiet_NaN(), 1, false, " m", "--- m");
+
+        beginTest ("Truncation");
+        {
+            char text[4];
+            expectEquals (GrisNumericReadout::format (text, 4, 123.4, 1, false, ""), 3);
+            expectEquals (String (text), String ("123"));
+
+            expectEquals (GrisNumericReadout::format (text, 1, 5.0, 0, false, ""), 0);
+            expectEquals (String (text), String());
+        }
+        {
+            // the degree sign is two bytes in UTF-8 and is never cut in half
+            char text[5];
+            expectEquals (GrisNumericReadout::format (text, 5, 1.0, 0, false, " \xc2\xb0"), 4);
+            expectEquals (String::fromUTF8 (text), String::fromUTF8 ("1 \xc2\xb0"));
+
+            expectEquals (GrisNumericReadout::format (text, 4, 1.0, 0, false, " \xc2\xb0"), 2);
+            expectEquals (String (text), String ("1 "));
+        }
+    }
+
+private:
+    void expectFormat (double value, int numDecimals, bool showPlusSign, const char* suffix, const char* expected){
+        char text[GrisNumericReadout::maxLength];
+        const int length = GrisNumericReadout::format (text, GrisNumericReadout::maxLength, value, numDecimals, showPlusSign, suffix);
+
+        expectEquals (String::fromUTF8 (text), String::fromUTF8 (expected));
+        expectEquals (length, (int) std::strlen (expected));
+    }
+};
+
+static GrisNumericReadoutTests grisNumericReadoutTests;
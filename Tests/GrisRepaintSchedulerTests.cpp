@@ -0,0 +1,92 @@
+/*
+ ==============================================================================
+
+ GrisRepaintSchedulerTests.cpp
+
+ Checks that GrisRepaintScheduler repaints each dirty client once per tick,
+ however many times it was marked dirty in between.
+
+ ==============================================================================
+ */
+
+#include "../GrisRepaintScheduler.h"
+
+#include <thread>
+
+class GrisRepaintSchedulerTests : public UnitTest {
+public:
+    GrisRepaintSchedulerTests() : UnitTest ("GrisRepaintScheduler", "GRIS") {}
+
+    void runTest() override{
+        CountingView a, b;
+        GrisRepaintScheduler& scheduler = a.getScheduler();
+
+        beginTest ("Clients share one scheduler");
+        expect (&scheduler == &b.getScheduler());
+        expectEquals (scheduler.getNumClients(), 2);
+
+        beginTest ("Marks are coalesced until the next tick");
+        scheduler.resetStats();
+        a.markDirty();
+        a.markDirty();
+        a.markDirty();
+        b.markDirty();
+        scheduler.flush();
+        expectEquals (a.numRepaints, 1);
+        expectEquals (b.numRepaints, 1);
+
+        GrisRepaintScheduler::Stats stats = scheduler.getStats();
+        expectEquals (stats.numTicks, (int64) 1);
+        expectEquals (stats.numRepaints, (int64) 2);
+        expectEquals (stats.numCoalesced, (int64) 2);
+
+        beginTest ("A tick without marks repaints nothing");
+        scheduler.flush();
+        expectEquals (a.numRepaints, 1);
+        expectEquals (b.numRepaints, 1);
+        expectEquals (scheduler.getStats().numRepaints, (int64) 2);
+
+        beginTest ("Marks from another thread");
+        {
+            std::thread audio ([&a]{
+                for (int i = 0; i < 1000; ++i)
+                    a.markDirty();
+            });
+            audio.join();
+        }
+        scheduler.flush();
+        expectEquals (a.numRepaints, 2);
+        expectEquals (b.numRepaints, 1);
+        expectEquals (scheduler.getStats().numCoalesced, (int64) 2 + 999);
+
+        beginTest ("Polling clients repaint on every tick");
+        b.setPolling (true);
+        scheduler.flush();
+        scheduler.flush();
+        expectEquals (a.numRepaints, 2);
+        expectEquals (b.numRepaints, 3);
+        b.setPolling (false);
+        scheduler.flush();
+        expectEquals (b.numRepaints, 3);
+
+        beginTest ("Deleted clients are unregistered");
+        {
+            CountingView c;
+            expectEquals (scheduler.getNumClients(), 3);
+        }
+        expectEquals (scheduler.getNumClients(), 2);
+    }
+
+private:
+    struct CountingView : public Component, public GrisRepaintScheduler::Client {
+        CountingView() : GrisRepaintScheduler::Client (static_cast<Component&> (*this)) {}
+
+        void handleRepaint() override{
+            ++this->numRepaints;
+        }
+
+        int numRepaints = 0;
+    };
+};
+
+static GrisRepaintSchedulerTests grisRepaintSchedulerTests;
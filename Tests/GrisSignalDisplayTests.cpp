@@ -0,0 +1,96 @@
+/*
+ ==============================================================================
+
+ GrisSignalDisplayTests.cpp
+
+ Checks that GrisSignalDisplay reduces each column of samples to its minimum,
+ maximum and RMS, whatever the blocks they were pushed in.
+
+ ==============================================================================
+ */
+
+#include "../GrisSignalDisplay.h"
+
+class GrisSignalDisplayTests : public UnitTest {
+public:
+    GrisSignalDisplayTests() : UnitTest ("GrisSignalDisplay", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+
+        beginTest ("Columns of one block");
+        {
+            GrisSignalDisplay display (lnf, 2);
+            display.setSize (10, 40);
+            display.setTimeSpan (100.0 / 48000.0, 48000.0);
+            expectEquals (display.getSamplesPerColumn(), 10);
+
+            // a step per column on the first channel, a square wave on the second
+            AudioSampleBuffer block (2, 100);
+
+            for (int i = 0; i < 100; ++i){
+                block.setSample (0, i, (i / 10) * 0.1f);
+                block.setSample (1, i, (i % 2) == 0 ? 0.5f : -0.5f);
+            }
+
+            display.pushBlock (block.getArrayOfReadPointers(), 100);
+            expectEquals (display.consume(), 100);
+
+            for (int x = 0; x < 10; ++x){
+                const GrisSignalDisplay::Column step (display.getColumn (0, x));
+                expectEquals (step.min, x * 0.1f);
+                expectEquals (step.max, x * 0.1f);
+                expect (std::abs (step.rms - x * 0.1f) < 1.0e-6f);
+
+                const GrisSignalDisplay::Column square (display.getColumn (1, x));
+                expectEquals (square.min, -0.5f);
+                expectEquals (square.max, 0.5f);
+                expect (std::abs (square.rms - 0.5f) < 1.0e-6f);
+            }
+
+            beginTest ("Newest column on the right");
+            block.clear();
+            block.setSample (0, 3, 1.0f);
+            display.pushBlock (block.getArrayOfReadPointers(), 10);
+            expectEquals (display.consume(), 10);
+            expectEquals (display.getColumn (0, 9).max, 1.0f);
+            expectEquals (display.getColumn (0, 9).min, 0.0f);
+            expectEquals (display.getColumn (0, 0).max, 0.1f);
+        }
+
+        beginTest ("Columns across blocks and runs");
+        {
+            GrisSignalDisplay display (lnf, 1);
+            display.setSize (4, 40);
+            display.setTimeSpan (4000.0 / 48000.0, 48000.0);
+            expectEquals (display.getSamplesPerColumn(), 1000);
+
+            // a ramp over each column, longer than the scratch buffer and split in odd blocks
+            AudioSampleBuffer block (1, 4000);
+            double sumSquares = 0.0;
+
+            for (int i = 0; i < 4000; ++i){
+                const float sample = (i % 1000) / 1000.0f - 0.25f;
+                block.setSample (0, i, sample);
+
+                if (i < 1000)
+                    sumSquares += sample * (double) sample;
+            }
+
+            for (int start = 0; start < 4000; start += 300){
+                const float* channel = block.getReadPointer (0, start);
+                display.pushBlock (&channel, jmin (300, 4000 - start));
+                display.consume();
+            }
+
+            for (int x = 0; x < 4; ++x){
+                const GrisSignalDisplay::Column c (display.getColumn (0, x));
+                expectEquals (c.min, -0.25f);
+                expectEquals (c.max, 999 / 1000.0f - 0.25f);
+                expect (std::abs (c.rms - (float) std::sqrt (sumSquares / 1000.0)) < 1.0e-4f);
+            }
+        }
+    }
+};
+
+static GrisSignalDisplayTests grisSignalDisplayTests;
@@ -0,0 +1,84 @@
+/*
+ ==============================================================================
+
+ GrisSpriteCacheTests.cpp
+
+ Checks the least-recently-used eviction of GrisSpriteCache and the keys built
+ by GrisSpriteKey.
+
+ ==============================================================================
+ */
+
+#include "../GrisSpriteCache.h"
+
+class GrisSpriteCacheTests : public UnitTest {
+public:
+    GrisSpriteCacheTests() : UnitTest ("GrisSpriteCache", "GRIS") {}
+
+    void runTest() override{
+        // 10 x 10 ARGB: 400 bytes each, so that the cache holds two of them
+        const Image sprite (Image::ARGB, 10, 10, true, SoftwareImageType());
+
+        beginTest ("Least recently used sprite is evicted");
+        {
+            GrisSpriteCache cache (1000);
+            cache.put (1, sprite);
+            cache.put (2, sprite);
+            expect (cache.get (1).isValid());
+
+            cache.put (3, sprite);
+            expectEquals (cache.getNumSprites(), 2);
+            expectEquals ((int) cache.getNumBytes(), 800);
+            expect (cache.get (1).isValid());
+            expect (! cache.get (2).isValid());
+            expect (cache.get (3).isValid());
+        }
+
+        beginTest ("Replacing a key keeps one entry");
+        {
+            GrisSpriteCache cache (1000);
+            cache.put (1, sprite);
+            cache.put (1, Image (Image::ARGB, 5, 5, true, SoftwareImageType()));
+            expectEquals (cache.getNumSprites(), 1);
+            expectEquals ((int) cache.getNumBytes(), 100);
+            expectEquals (cache.get (1).getWidth(), 5);
+        }
+
+        beginTest ("Shrinking the budget trims, but keeps the newest sprite");
+        {
+            GrisSpriteCache cache (1000);
+            cache.put (1, sprite);
+            cache.put (2, sprite);
+            cache.setMaxBytes (500);
+            expectEquals (cache.getNumSprites(), 1);
+            expect (cache.get (2).isValid());
+
+            cache.setMaxBytes (100);
+            expectEquals (cache.getNumSprites(), 1);
+        }
+
+        beginTest ("Hit rate");
+        {
+            GrisSpriteCache cache;
+            cache.put (1, sprite);
+            cache.get (1);
+            cache.get (1);
+            cache.get (1);
+            cache.get (2);
+            expectEquals (cache.getNumHits(), 3);
+            expectEquals (cache.getNumMisses(), 1);
+            expectEquals (cache.getHitRate(), 0.75f);
+
+            cache.resetStats();
+            expectEquals (cache.getHitRate(), 0.0f);
+        }
+
+        beginTest ("Keys");
+        expect (GrisSpriteKey (1).add (0.5f).get() == GrisSpriteKey (1).add (0.5001f).get());
+        expect (GrisSpriteKey (1).add (0.5f).get() != GrisSpriteKey (1).add (0.51f).get());
+        expect (GrisSpriteKey (1).add (true).get() != GrisSpriteKey (2).add (true).get());
+        expect (GrisSpriteKey (1).add (2).add (3).get() != GrisSpriteKey (1).add (3).add (2).get());
+    }
+};
+
+static GrisSpriteCacheTests grisSpriteCacheTests;
@@ -0,0 +1,51 @@
+/*
+ ==============================================================================
+
+ GrisSpriteWarmUpTests.cpp
+
+ Checks that GrisSpriteWarmUp keeps the rotary frames within the filmstrip
+ cache, so that every frame it rendered is still a hit afterwards.
+
+ ==============================================================================
+ */
+
+#include "../GrisSpriteWarmUp.h"
+
+class GrisSpriteWarmUpTests : public UnitTest {
+public:
+    GrisSpriteWarmUpTests() : UnitTest ("GrisSpriteWarmUp", "GRIS") {}
+
+    void runTest() override{
+        beginTest ("Rotary frames stop at the cache budget and stay cached");
+
+        // 60 x 60 at scale 2 is 57600 bytes a frame: 18 of the 3 x 128 fit in 1 MB
+        GrisLookAndFeel lnf;
+        lnf.setRotaryFilmstripEnabled (true, 128, 1024 * 1024);
+
+        GrisSpriteWarmUp::Sizes sizes;
+        sizes.scale = 2.0f;
+        sizes.rotarySliders.add (Rectangle<int> (60, 60));
+
+        GrisSpriteWarmUp warmUp (lnf, sizes);
+
+        for (int i = 0; i < 1000 && ! warmUp.isFinished(); ++i)
+            Thread::sleep (10);
+
+        expect (warmUp.isFinished());
+        expectEquals (warmUp.getNumRotaryFramesWarmed(), 18);
+
+        const GrisSpriteCache& cache = lnf.getRotaryFilmstripCache();
+        expect (cache.getNumBytes() <= cache.getMaxBytes());
+        expectEquals (cache.getNumSprites(), warmUp.getNumRotaryFramesWarmed());
+
+        const Colour colour (lnf.getThemePtr()->getColour (GrisTheme::rotarySlider, GrisTheme::normal));
+        const int missesBefore = cache.getNumMisses();
+
+        for (int frame = 0; frame < warmUp.getNumRotaryFramesWarmed(); ++frame)
+            lnf.getRotaryFrameSprite (60, 60, sizes.rotaryStartAngle, sizes.rotaryEndAngle, colour, frame, 128, sizes.scale);
+
+        expectEquals (cache.getNumMisses(), missesBefore);
+    }
+};
+
+static GrisSpriteWarmUpTests grisSpriteWarmUpTests;
@@ -0,0 +1,110 @@
+/*
+ ==============================================================================
+
+ GrisTextLayoutCacheTests.cpp
+
+ Checks that GrisTextLayoutCache draws what Graphics::drawFittedText draws, and
+ its least-recently-used eviction.
+
+ ==============================================================================
+ */
+
+#include "../GrisFonts.h"
+#include "../GrisTextLayoutCache.h"
+
+class GrisTextLayoutCacheTests : public UnitTest {
+public:
+    GrisTextLayoutCacheTests() : UnitTest ("GrisTextLayoutCache", "GRIS") {}
+
+    void runTest() override{
+        SharedResourcePointer<GrisSharedTypeface> typeface;
+        const Font font (Font (typeface->getTypeface()).withHeight (GrisFontMetrics::getBaseHeight()));
+        Image image (Image::ARGB, 40, 20, true, SoftwareImageType());
+        Graphics g (image);
+        g.setColour (Colours::white);
+
+        beginTest ("Same pixels as drawFittedText");
+        {
+            GrisTextLayoutCache cache;
+            Image expected (Image::ARGB, 40, 20, true, SoftwareImageType());
+
+            {
+                Graphics eg (expected);
+                eg.setColour (Colours::white);
+                eg.setFont (font);
+                eg.drawFittedText ("12", 0, 0, 40, 20, Justification::centred, 1);
+            }
+
+            for (int pass = 0; pass < 2; ++pass){
+                image.clear (image.getBounds());
+                cache.drawFittedText (g, font, "12", 0, 0, 40, 20, Justification::centred, 1);
+                expectEquals (countDifferentPixels (image, expected), 0);
+            }
+
+            expectEquals (cache.getNumMisses(), 1);
+            expectEquals (cache.getNumHits(), 1);
+        }
+
+        beginTest ("Least recently used string is evicted");
+        {
+            GrisTextLayoutCache cache (2);
+            draw (cache, g, font, "a");
+            draw (cache, g, font, "b");
+            draw (cache, g, font, "a");
+            expectEquals (cache.getNumHits(), 1);
+
+            draw (cache, g, font, "c");
+            expectEquals (cache.getNumEntries(), 2);
+
+            cache.resetCounters();
+            draw (cache, g, font, "a");
+            draw (cache, g, font, "c");
+            draw (cache, g, font, "b");
+            expectEquals (cache.getNumHits(), 2);
+            expectEquals (cache.getNumMisses(), 1);
+        }
+
+        beginTest ("The same string at another place is another entry");
+        {
+            GrisTextLayoutCache cache;
+            cache.drawFittedText (g, font, "a", 0, 0, 20, 20, Justification::centred, 1);
+            cache.drawFittedText (g, font, "a", 20, 0, 20, 20, Justification::centred, 1);
+            expectEquals (cache.getNumEntries(), 2);
+            expectEquals (cache.getNumHits(), 0);
+        }
+
+        beginTest ("Limit");
+        {
+            GrisTextLayoutCache cache;
+            cache.reserve (100);
+            expectEquals (cache.getMaxEntries(), (int) GrisTextLayoutCache::defaultMaxEntries + 100);
+            cache.reserve (10);
+            expectEquals (cache.getMaxEntries(), (int) GrisTextLayoutCache::defaultMaxEntries + 100);
+
+            cache.setMaxEntries (1);
+            draw (cache, g, font, "a");
+            draw (cache, g, font, "b");
+            expectEquals (cache.getNumEntries(), 1);
+        }
+    }
+
+private:
+    static void draw (GrisTextLayoutCache& cache, Graphics& g, const Font& font, const String& text){
+        cache.drawFittedText (g, font, text, 0, 0, 40, 20, Justification::centred, 1);
+    }
+
+    static int countDifferentPixels (const Image& a, const Image& b){
+        const Image::BitmapData da (a, Image::BitmapData::readOnly);
+        const Image::BitmapData db (b, Image::BitmapData::readOnly);
+        int numDifferent = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (da.getPixelColour (x, y) != db.getPixelColour (x, y))
+                    ++numDifferent;
+
+        return numDifferent;
+    }
+};
+
+static GrisTextLayoutCacheTests grisTextLayoutCacheTests;
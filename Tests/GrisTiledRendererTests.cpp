@@ -0,0 +1,80 @@
+/*
+ ==============================================================================
+
+ GrisTiledRendererTests.cpp
+
+ Checks that GrisTiledRenderer paints a small editor exactly as the serial
+ paint does, with one and several threads.
+
+ ==============================================================================
+ */
+
+#include "../GrisTiledRenderer.h"
+#include "../GrisLookAndFeel.h"
+
+class GrisTiledRendererTests : public UnitTest {
+public:
+    GrisTiledRendererTests() : UnitTest ("GrisTiledRenderer", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+
+        // made up front, so that text is blitted the same way by both paints
+        lnf.getGlyphAtlas (1.0f);
+        lnf.getGlyphAtlas (2.0f);
+
+        // destroyed after the editor, which only refers to them
+        OwnedArray<Component> children;
+        Filled editor (lnf.getWinBackgroundColour());
+        editor.setLookAndFeel (&lnf);
+        editor.setSize (240, 120);
+
+        for (int p = 0; p < 4; ++p){
+            Filled* panel = new Filled (lnf.getTheme().background);
+            children.add (panel);
+            panel->setBounds ((p % 2) * 120, (p / 2) * 60, 120, 60);
+            editor.addAndMakeVisible (panel);
+
+            Slider* slider = new Slider (Slider::LinearHorizontal, Slider::NoTextBox);
+            children.add (slider);
+            slider->setRange (0.0, 1.0);
+            slider->setValue (p / 4.0, dontSendNotification);
+            slider->setBounds (4, 4, 112, 20);
+            panel->addAndMakeVisible (slider);
+
+            Label* label = new Label (String(), "-" + String (p * 6) + " dB");
+            children.add (label);
+            label->setBounds (4, 30, 56, 24);
+            panel->addAndMakeVisible (label);
+
+            ToggleButton* toggle = new ToggleButton (String (p + 1));
+            children.add (toggle);
+            toggle->setToggleState (p % 2 == 0, dontSendNotification);
+            toggle->setBounds (64, 30, 52, 24);
+            panel->addAndMakeVisible (toggle);
+        }
+
+        const float scales[] = { 1.0f, 2.0f };
+        const int threads[] = { 1, 4 };
+
+        for (int s = 0; s < numElementsInArray (scales); ++s){
+            for (int t = 0; t < numElementsInArray (threads); ++t){
+                beginTest ("Same pixels as the serial paint at scale " + String (scales[s]) + " with " + String (threads[t]) + " threads");
+                expectEquals (GrisTiledRenderer::compareWithSerial (editor, scales[s], threads[t]), 0);
+            }
+        }
+    }
+
+private:
+    struct Filled : public Component {
+        explicit Filled (Colour c) : colour (c) {}
+
+        void paint (Graphics& g) override{
+            g.fillAll (this->colour);
+        }
+
+        const Colour colour;
+    };
+};
+
+static GrisTiledRendererTests grisTiledRendererTests;
@@ -0,0 +1,105 @@
+/*
+ ==============================================================================
+
+ GrisToggleGridTests.cpp
+
+ Checks the cell arithmetic of GrisToggleGrid and that changes only repaint the
+ cells that differ.
+
+ ==============================================================================
+ */
+
+#include "../GrisToggleGrid.h"
+
+class GrisToggleGridTests : public UnitTest {
+public:
+    GrisToggleGridTests() : UnitTest ("GrisToggleGrid", "GRIS") {}
+
+    void runTest() override{
+        GrisLookAndFeel lnf;
+        GrisToggleGrid grid (lnf, 4, 2);
+        grid.setSize (100, 50);
+        grid.setVisible (true);
+
+        // the grid owns it
+        RepaintRecorder* recorder = new RepaintRecorder();
+        grid.setCachedComponentImage (recorder);
+
+        beginTest ("Cell under a point");
+        expectEquals (grid.getCellAt (Point<int> (0, 0)), 0);
+        expectEquals (grid.getCellAt (Point<int> (24, 24)), 0);
+        expectEquals (grid.getCellAt (Point<int> (25, 0)), 1);
+        expectEquals (grid.getCellAt (Point<int> (50, 25)), 6);
+        expectEquals (grid.getCellAt (Point<int> (99, 49)), 7);
+        expectEquals (grid.getCellAt (Point<int> (100, 0)), -1);
+        expectEquals (grid.getCellAt (Point<int> (0, -1)), -1);
+
+        beginTest ("Cell bounds");
+        expect (grid.getCellBounds (1) == Rectangle<int> (25, 0, 25, 25));
+        expect (grid.getCellBounds (6) == Rectangle<int> (50, 25, 25, 25));
+
+        for (int i = 0; i < grid.getNumCells(); ++i)
+            expectEquals (grid.getCellAt (grid.getCellBounds (i).getCentre()), i);
+
+        beginTest ("Setting every state repaints the cells that differ");
+        {
+            BigInteger states;
+            states.setBit (1);
+            states.setBit (6);
+            states.setBit (9); // past the last cell: dropped
+
+            recorder->clear();
+            grid.setCellStates (states);
+            expect (grid.getCellState (1));
+            expect (grid.getCellState (6));
+            expectEquals (grid.getCellStates().getHighestBit(), 6);
+            expect (! recorder->invalidatedAll);
+            expectEquals (recorder->areas.size(), 2);
+            expect (recorder->areas.contains (grid.getCellBounds (1)));
+            expect (recorder->areas.contains (grid.getCellBounds (6)));
+
+            states.clear();
+            states.setBit (1);
+            recorder->clear();
+            grid.setCellStates (states);
+            expect (! grid.getCellState (6));
+            expectEquals (recorder->areas.size(), 1);
+            expect (recorder->areas.contains (grid.getCellBounds (6)));
+
+            recorder->clear();
+            grid.setCellStates (states);
+            expect (recorder->areas.isEmpty());
+        }
+
+        beginTest ("Setting one state");
+        recorder->clear();
+        grid.setCellState (3, true);
+        grid.setCellState (3, true);
+        expectEquals (recorder->areas.size(), 1);
+        expect (recorder->areas.contains (grid.getCellBounds (3)));
+
+        beginTest ("Disabling the grid repaints it");
+        recorder->clear();
+        grid.setEnabled (false);
+        expect (recorder->invalidatedAll);
+        expect (! grid.isCellEnabled (0));
+    }
+
+private:
+    struct RepaintRecorder : public CachedComponentImage {
+        void paint (Graphics&) override {}
+        bool invalidateAll() override                       { this->invalidatedAll = true; return false; }
+        bool invalidate (const Rectangle<int>& area) override { this->areas.add (area); return false; }
+        void releaseResources() override {}
+
+        void clear(){
+            this->areas.clearQuick();
+            this->invalidatedAll = false;
+        }
+
+        Array<Rectangle<int>> areas;
+        bool invalidatedAll = false;
+    };
+};
+
+static GrisToggleGridTests grisToggleGridTests;
@@ -0,0 +1,112 @@
+/*
+ ==============================================================================
+
+ GrisTrajectoryTests.cpp
+
+ Checks the levels of GrisTrajectory, what falls off the end of their rings and
+ the area that update() reports.
+
+ ==============================================================================
+ */
+
+#include "../GrisTrajectory.h"
+
+class GrisTrajectoryTests : public UnitTest {
+public:
+    GrisTrajectoryTests() : UnitTest ("GrisTrajectory", "GRIS") {}
+
+    void runTest() override{
+        beginTest ("Sparse points cover the same length at every level");
+        {
+            GrisTrajectory trajectory (64, 5, 1024);
+
+            // further apart than the tolerance of the coarsest level, so every level keeps every point
+            for (int i = 0; i < 200; ++i)
+                trajectory.push (i * 0.05f, 0.0f);
+
+            trajectory.update();
+            expect (trajectory.getTolerance (trajectory.getNumLevels() - 1) < 0.05f);
+
+            const float length = getLength (trajectory, 0);
+            expect (std::abs (length - 63 * 0.05f) < 1.0e-3f);
+
+            for (int level = 1; level < trajectory.getNumLevels(); ++level){
+                expectEquals (trajectory.getNumPoints (level), 64);
+                expect (std::abs (getLength (trajectory, level) - length) < 1.0e-3f);
+            }
+        }
+
+        beginTest ("Dense points cover more at coarser levels");
+        {
+            GrisTrajectory trajectory (64, 3, 1024);
+
+            for (int i = 0; i < 400; ++i)
+                trajectory.push (i * 0.002f, 0.0f);
+
+            trajectory.update();
+
+            for (int level = 1; level < trajectory.getNumLevels(); ++level)
+                expect (getLength (trajectory, level) >= getLength (trajectory, level - 1));
+        }
+
+        beginTest ("Update area and eviction");
+        {
+            GrisTrajectory trajectory (4, 1, 16);
+
+            for (int i = 0; i < 4; ++i)
+                trajectory.push (i * 0.1f, 0.0f);
+
+            GrisTrajectory::Update u (trajectory.update());
+            expect (u.hasArea);
+            expect (! u.evicted);
+            expect (u.area.getX() == 0.0f);
+            expect (std::abs (u.area.getRight() - 0.3f) < 1.0e-6f);
+            expectEquals (trajectory.getNumPoints (0), 4);
+
+            // a fifth point pushes the first one out, and its segment is part of the area
+            trajectory.push (0.4f, 0.5f);
+            u = trajectory.update();
+            expect (u.evicted);
+            expectEquals (trajectory.getNumPoints (0), 4);
+            expect (trajectory.getPoint (0, 0) == Point<float> (0.1f, 0.0f));
+            expect (trajectory.getPoint (0, 3) == Point<float> (0.4f, 0.5f));
+            expect (u.area.getX() == 0.0f);
+            expect (u.area.getY() == 0.0f);
+            expect (std::abs (u.area.getRight() - 0.4f) < 1.0e-6f);
+            expect (std::abs (u.area.getBottom() - 0.5f) < 1.0e-6f);
+
+            // within the tolerance of the last point kept: only the head moves
+            trajectory.push (0.4005f, 0.5f);
+            u = trajectory.update();
+            expect (u.isEmpty());
+
+            Point<float> head;
+            expect (trajectory.getHead (head));
+            expect (head == Point<float> (0.4005f, 0.5f));
+        }
+
+        beginTest ("Points pushed to a full FIFO are dropped");
+        {
+            GrisTrajectory trajectory (4, 1, 16);
+            int numPushed = 0;
+
+            for (int i = 0; i < 20; ++i)
+                numPushed += trajectory.push (i * 0.1f, 0.0f) ? 1 : 0;
+
+            expectEquals ((int) trajectory.getNumDropped(), 20 - numPushed);
+            expect (trajectory.getNumDropped() > 0);
+        }
+    }
+
+private:
+    static float getLength (const GrisTrajectory& trajectory, int level){
+        float length = 0.0f;
+
+        for (int i = 1; i < trajectory.getNumPoints (level); ++i)
+            length += trajectory.getPoint (level, i - 1).getDistanceFrom (trajectory.getPoint (level, i));
+
+        return length;
+    }
+};
+
+static GrisTrajectoryTests grisTrajectoryTests;
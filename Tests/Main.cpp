@@ -0,0 +1,55 @@
+/*
+ ==============================================================================
+
+ Main.cpp
+
+ Console runner of the GRIS unit tests. Every header of the repository is
+ included here, so that this target also checks that each one compiles on its own
+ terms; the exit code is non zero when a test fails.
+
+ ==============================================================================
+ */
+
+#include "../GrisAllocationCounter.h"
+#include "../GrisDeltaSlider.h"
+#include "../GrisFieldRenderer.h"
+#include "../GrisFonts.h"
+#include "../GrisGlyphAtlas.h"
+#include "../GrisLevelMeterBank.h"
+#include "../GrisLookAndFeel.h"
+#include "../GrisLookAndFeelBenchmark.h"
+#include "../GrisNumericReadout.h"
+#include "../GrisPaintInstrumentation.h"
+#include "../GrisRepaintScheduler.h"
+#include "../GrisSignalDisplay.h"
+#include "../GrisSpriteCache.h"
+#include "../GrisSpriteWarmUp.h"
+#include "../GrisTextLayoutCache.h"
+#include "../GrisTheme.h"
+#include "../GrisTiledRenderer.h"
+#include "../GrisToggleGrid.h"
+#include "../GrisTrajectory.h"
+#include "../GrisWorkerPool.h"
+
+int main(){
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    // glyph atlases go to a directory of their own rather than the user's cache
+    const File atlasDirectory (File::getSpecialLocation (File::tempDirectory).getNonexistentChildFile ("GrisGlyphAtlas", String()));
+    int numFailures = 0;
+
+    {
+        SharedResourcePointer<GrisGlyphAtlasCache> glyphAtlases;
+        glyphAtlases->setCacheDirectory (atlasDirectory);
+
+        UnitTestRunner runner;
+        runner.setAssertOnFailure (false);
+        runner.runTestsInCategory ("GRIS");
+
+        for (int i = 0; i < runner.getNumResults(); ++i)
+            numFailures += runner.getResult (i)->failures;
+    }
+
+    atlasDirectory.deleteRecursively();
+    return numFailures > 0 ? 1 : 0;
+}